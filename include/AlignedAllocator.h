@@ -0,0 +1,53 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef AlignedAllocator_H
+#define AlignedAllocator_H
+
+#include <vector>
+#include <cstddef>
+#include <new>
+
+// Allocator whose storage starts on an `Alignment` byte boundary, so vector
+// loads over the arrays never straddle a cache line at the start.
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &)
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T *pointer, std::size_t)
+    {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment> &) const
+    {
+        return true;
+    }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+#endif
@@ -0,0 +1,83 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef CandidateBatch_H
+#define CandidateBatch_H
+
+#include <vector>
+#include "ParticleStore.h"
+#include "PeriodicQuery.h"
+
+// A spatially coherent group of queries together with every particle that
+// can be a neighbour of any of them. It answers for_each_neighbor for its
+// own queries by filtering the shared candidates, so it can stand in for
+// the index it was gathered from.
+class CandidateBatch
+{
+private:
+    const ParticleStore *particles;
+    Real width, height;
+
+    PeriodicQuery bounds(Real radius) const;
+
+public:
+    std::vector<int> queries;
+    std::vector<int> candidates;
+
+    CandidateBatch(const ParticleStore &particles, Real width, Real height);
+
+    template <typename Visit>
+    void gather(const int *queries, int n, Real radius, Visit &&visit);
+
+    template <typename F>
+    void for_each_candidate_range(int query, Real radius, F &&f) const;
+
+    template <typename F>
+    void for_each_neighbor(int query, Real radius, F &&f) const;
+};
+
+// Makes queries[k] for k < n the batch's queries and collects their candidates. visit(bounds,
+// collect) has to pass every range of particles that may reach into the bounds disk to
+// collect(candidates, n), which keeps the ones inside it.
+template <typename Visit>
+void CandidateBatch::gather(const int *queries, int n, Real radius, Visit &&visit)
+{
+    this->queries.assign(queries, queries + n);
+    candidates.clear();
+
+    PeriodicQuery bounds = this->bounds(radius);
+    auto collect = [&](const int *range, int n_range) {
+        for (int k = 0; k < n_range; k++)
+            if (bounds.position.toroidal_offset(particles->position(range[k]), width, height).length2() < bounds.radius * bounds.radius)
+                candidates.push_back(range[k]);
+    };
+    visit(bounds, collect);
+}
+
+// Every query of the batch shares the same candidates.
+template <typename F>
+void CandidateBatch::for_each_candidate_range(int, Real, F &&f) const
+{
+    f(candidates.data(), static_cast<int>(candidates.size()));
+}
+
+template <typename F>
+void CandidateBatch::for_each_neighbor(int query, Real radius, F &&f) const
+{
+    Vector2D position = particles->position(query);
+    for (int particle : candidates)
+    {
+        Vector2D offset = position.toroidal_offset(particles->position(particle), width, height);
+        if (offset.length2() < radius * radius)
+            f(particle, offset);
+    }
+}
+
+// Indices that can hand out their leaf buckets as CandidateBatches.
+template <typename Index>
+concept BatchedIndex = requires(const Index &index, Real radius) {
+    index.for_each_batch(radius, [](const CandidateBatch &) {});
+};
+
+#endif
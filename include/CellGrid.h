@@ -0,0 +1,142 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef CellGrid_H
+#define CellGrid_H
+
+#include <vector>
+#include <cmath>
+#include "ParticleStore.h"
+#include "SpatialIndex.h"
+#include "CountingSort.h"
+#include "ThreadPool.h"
+
+// Uniform cell list over the periodic simulation area. Particles are bucketed
+// with a counting sort, so every cell is a contiguous range of `items`. A grid
+// built with slack leaves that many free slots after every cell, so update()
+// can move the particles that changed cell without sorting everything again.
+class CellGrid : public SpatialIndex<CellGrid>
+{
+private:
+    friend class SpatialIndex<CellGrid>;
+
+    Real width = 0, height = 0;
+    Real cell_width = 0, cell_height = 0;
+    int columns = 0, rows = 0;
+
+    const ParticleStore *particles = nullptr;
+    CountingSort cells;
+    std::vector<int> cell_of;
+    std::vector<int> items;
+    std::vector<int> cell_begin, cell_end;
+
+    // Only for grids built with slack: where each particle sits in items.
+    bool updatable = false;
+    std::vector<int> slot_of;
+    std::vector<std::vector<int>> crossed;
+
+    int column(Real x) const;
+
+    int row(Real y) const;
+
+public:
+    CellGrid();
+
+    void build(const ParticleStore &particles, Real width, Real height, Real cell_size, ThreadPool &pool, int slack = 0);
+
+    bool update(ThreadPool &pool);
+
+    template <typename F>
+    void for_each_candidate_range(int query, Real radius, F &&f) const;
+
+    template <typename F>
+    void for_each_pair(Real radius, F &&f) const;
+};
+
+// Calls f(candidates, n) for every cell in reach of the query, candidates
+// being the n particles in it.
+template <typename F>
+void CellGrid::for_each_candidate_range(int query, Real radius, F &&f) const
+{
+    Vector2D position = particles->position(query);
+    int span_x = static_cast<int>(std::ceil(radius / cell_width));
+    int span_y = static_cast<int>(std::ceil(radius / cell_height));
+
+    // Once the stencil wraps onto itself every column (or row) is visited exactly once.
+    int first_x = column(position.x) - span_x, last_x = column(position.x) + span_x;
+    int first_y = row(position.y) - span_y, last_y = row(position.y) + span_y;
+    if (2 * span_x + 1 >= columns)
+    {
+        first_x = 0;
+        last_x = columns - 1;
+    }
+    if (2 * span_y + 1 >= rows)
+    {
+        first_y = 0;
+        last_y = rows - 1;
+    }
+
+    for (int y = first_y; y <= last_y; y++)
+    {
+        int r = (y + rows) % rows;
+        for (int x = first_x; x <= last_x; x++)
+        {
+            int c = r * columns + (x + columns) % columns;
+            f(items.data() + cell_begin[c], cell_end[c] - cell_begin[c]);
+        }
+    }
+}
+
+// Calls f(a, b, offset) once for every unordered pair closer than radius,
+// offset being the minimum-image displacement from a to b.
+template <typename F>
+void CellGrid::for_each_pair(Real radius, F &&f) const
+{
+    auto visit = [&](int k, int l) {
+        Vector2D offset = particles->position(items[k]).toroidal_offset(particles->position(items[l]), width, height);
+        if (offset.length2() < radius * radius)
+            f(items[k], items[l], offset);
+    };
+
+    int span_x = static_cast<int>(std::ceil(radius / cell_width));
+    int span_y = static_cast<int>(std::ceil(radius / cell_height));
+
+    // The half stencil only meets every pair of cells once as long as it does not wrap onto itself.
+    if (2 * span_x + 1 > columns || 2 * span_y + 1 > rows)
+    {
+        for (int c = 0; c < columns * rows; c++)
+            for (int k = cell_begin[c]; k < cell_end[c]; k++)
+                for (int d = c; d < columns * rows; d++)
+                    for (int l = d == c ? k + 1 : cell_begin[d]; l < cell_end[d]; l++)
+                        visit(k, l);
+        return;
+    }
+
+    for (int y = 0; y < rows; y++)
+    {
+        for (int x = 0; x < columns; x++)
+        {
+            int c = y * columns + x;
+            for (int k = cell_begin[c]; k < cell_end[c]; k++)
+                for (int l = k + 1; l < cell_end[c]; l++)
+                    visit(k, l);
+
+            for (int dy = 0; dy <= span_y; dy++)
+            {
+                for (int dx = -span_x; dx <= span_x; dx++)
+                {
+                    if (dy == 0 && dx <= 0)
+                        continue;
+
+                    int other = ((y + dy) % rows) * columns + (x + dx + columns) % columns;
+                    for (int k = cell_begin[c]; k < cell_end[c]; k++)
+                        for (int l = cell_begin[other]; l < cell_end[other]; l++)
+                            visit(k, l);
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,35 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef CountingSort_H
+#define CountingSort_H
+
+#include <vector>
+#include "ThreadPool.h"
+
+// Stable counting sort of the indices [0, n) by integer key, with scratch
+// space kept between calls. With more than one thread the key range is cut
+// into one band per thread: indices are first scattered by band, then every
+// band is sorted on its own, so no thread needs a histogram of all keys.
+class CountingSort
+{
+private:
+    std::vector<int> banded;
+    std::vector<int> band_counts;
+    std::vector<int> band_start;
+    std::vector<int> fill;
+
+    void sort_range(const std::vector<int> &keys, const int *indices, int n, int first_key, int last_key, int offset);
+
+public:
+    // Key k owns order[start[k]] up to order[start[k + 1]].
+    std::vector<int> start;
+    std::vector<int> order;
+
+    CountingSort();
+
+    void sort(const std::vector<int> &keys, int n_keys, ThreadPool &pool);
+};
+
+#endif
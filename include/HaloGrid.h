@@ -0,0 +1,76 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef HaloGrid_H
+#define HaloGrid_H
+
+#include <vector>
+#include <cmath>
+#include "ParticleStore.h"
+#include "SpatialIndex.h"
+#include "CountingSort.h"
+#include "ThreadPool.h"
+
+// Cell list over the simulation area padded by a ghost layer as wide as the
+// largest query radius. Particles near a border are copied into the layer on
+// the opposite side, so queries measure plain Euclidean offsets and never
+// wrap. Positions are copied at build time, neighbours are therefore seen
+// where they were at the start of the step.
+class HaloGrid : public SpatialIndex<HaloGrid>
+{
+private:
+    Real halo = 0;
+    Real cell_width = 0, cell_height = 0;
+    int columns = 0, rows = 0;
+
+    CountingSort cells;
+    std::vector<int> cell_of;
+    std::vector<int> chunk_start;
+    std::vector<Vector2D> ghost_points;
+    std::vector<int> ghost_sources;
+    std::vector<Vector2D> points;
+    std::vector<int> sources;
+    const ParticleStore *particles = nullptr;
+
+    int column(Real x) const;
+
+    int row(Real y) const;
+
+public:
+    HaloGrid();
+
+    void build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool);
+
+    template <typename F>
+    void for_each_neighbor(int query, Real radius, F &&f) const;
+};
+
+// Calls f(particle, offset) for every particle within radius of the query,
+// offset being the displacement from the query to the nearest copy.
+template <typename F>
+void HaloGrid::for_each_neighbor(int query, Real radius, F &&f) const
+{
+    // Padded coordinates, the simulation area starts at (halo, halo).
+    Real x = particles->x[query] + halo, y = particles->y[query] + halo;
+
+    int span_x = static_cast<int>(std::ceil(radius / cell_width));
+    int span_y = static_cast<int>(std::ceil(radius / cell_height));
+    int first_x = std::max(column(x) - span_x, 0), last_x = std::min(column(x) + span_x, columns - 1);
+    int first_y = std::max(row(y) - span_y, 0), last_y = std::min(row(y) + span_y, rows - 1);
+
+    for (int r = first_y; r <= last_y; r++)
+    {
+        for (int c = r * columns + first_x; c <= r * columns + last_x; c++)
+        {
+            for (int k = cells.start[c]; k < cells.start[c + 1]; k++)
+            {
+                Vector2D offset{points[k].x - x, points[k].y - y};
+                if (offset.length2() < radius * radius)
+                    f(sources[k], offset);
+            }
+        }
+    }
+}
+
+#endif
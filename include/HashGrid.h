@@ -0,0 +1,95 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef HashGrid_H
+#define HashGrid_H
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include "ParticleStore.h"
+#include "SpatialIndex.h"
+#include "ThreadPool.h"
+#include "CountingSort.h"
+
+// Cell list that only stores the occupied cells, in an open-addressing hash
+// table keyed on the wrapped cell coordinates. Memory grows with the number
+// of particles rather than with the simulation area, which suits huge worlds
+// that are mostly empty. Cells fit the largest radius of any species.
+class HashGrid : public SpatialIndex<HashGrid>
+{
+private:
+    friend class SpatialIndex<HashGrid>;
+
+    struct Cell
+    {
+        std::uint64_t key;
+        int begin, end;
+    };
+
+    constexpr static std::uint64_t empty = ~std::uint64_t(0);
+
+    Real width = 0, height = 0;
+    Real cell_width = 0, cell_height = 0;
+    std::int64_t columns = 0, rows = 0;
+
+    const ParticleStore *particles = nullptr;
+    std::vector<Cell> table;
+    std::uint64_t mask = 0;
+    std::vector<int> slot_of;
+    CountingSort cells;
+
+    std::int64_t column(Real x) const;
+
+    std::int64_t row(Real y) const;
+
+    std::uint64_t home(std::uint64_t key) const;
+
+    const Cell *find(std::uint64_t key) const;
+
+public:
+    HashGrid();
+
+    void build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool);
+
+    template <typename F>
+    void for_each_candidate_range(int query, Real radius, F &&f) const;
+};
+
+// Calls f(candidates, n) for every occupied cell in reach of the query,
+// candidates being the n particles in it.
+template <typename F>
+void HashGrid::for_each_candidate_range(int query, Real radius, F &&f) const
+{
+    Vector2D position = particles->position(query);
+    std::int64_t span_x = static_cast<std::int64_t>(std::ceil(radius / cell_width));
+    std::int64_t span_y = static_cast<std::int64_t>(std::ceil(radius / cell_height));
+
+    // Once the stencil wraps onto itself every column (or row) is visited exactly once.
+    std::int64_t first_x = column(position.x) - span_x, last_x = column(position.x) + span_x;
+    std::int64_t first_y = row(position.y) - span_y, last_y = row(position.y) + span_y;
+    if (2 * span_x + 1 >= columns)
+    {
+        first_x = 0;
+        last_x = columns - 1;
+    }
+    if (2 * span_y + 1 >= rows)
+    {
+        first_y = 0;
+        last_y = rows - 1;
+    }
+
+    for (std::int64_t y = first_y; y <= last_y; y++)
+    {
+        std::int64_t r = (y + rows) % rows;
+        for (std::int64_t x = first_x; x <= last_x; x++)
+        {
+            const Cell *cell = find(static_cast<std::uint64_t>(r * columns + (x + columns) % columns));
+            if (cell != nullptr)
+                f(cells.order.data() + cell->begin, cell->end - cell->begin);
+        }
+    }
+}
+
+#endif
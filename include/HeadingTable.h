@@ -0,0 +1,32 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef HeadingTable_H
+#define HeadingTable_H
+
+#include <vector>
+#include <cstdint>
+#include "Real.h"
+
+// Headings are 32-bit fixed point fractions of a full turn, so adding a turn
+// wraps around on overflow without any range checks.
+std::uint32_t heading_from_turns(double turns);
+
+Real turns_from_heading(std::uint32_t heading);
+
+// Cosine and sine of a heading. With 0 bits they are computed exactly,
+// otherwise read from a table of 2^bits cosines, trading accuracy for speed.
+class HeadingTable
+{
+private:
+    int bits = 0;
+    std::vector<Real> cosines;
+
+public:
+    explicit HeadingTable(int bits = 0);
+
+    void direction(std::uint32_t heading, Real &c, Real &s) const;
+};
+
+#endif
@@ -7,42 +7,138 @@
 #define KDTree_H
 
 #include <vector>
-#include <memory>
-#include "Particle.h"
+#include "ParticleStore.h"
+#include "PeriodicQuery.h"
+#include "SpatialIndex.h"
+#include "CandidateBatch.h"
+#include "ThreadPool.h"
 
-class Node
+// Implicit KD-tree: the children of node i are 2i + 1 and 2i + 2, every
+// internal node splits its range of `order` at the median and the leaves are
+// small buckets of particle indices.
+class KDTree : public SpatialIndex<KDTree>
 {
+private:
+    friend class SpatialIndex<KDTree>;
+
+    struct Node
+    {
+        Real split;
+        bool vertical;
+    };
+
+    struct Subtree
+    {
+        int node, begin, end, level;
+    };
+
+    Real width = 0, height = 0;
+    int depth = 0;
+
+    const ParticleStore *particles = nullptr;
+    std::vector<int> order;
+    std::vector<Node> nodes;
+    std::vector<Subtree> subtrees;
+
+    void prepare(const ParticleStore &particles, Real width, Real height);
+
+    void build(int node, int begin, int end, int level);
+
+    void split(int node, int begin, int end);
+
+    template <typename F>
+    void visit(const PeriodicQuery &query, unsigned images, int node, int begin, int end, int level, F &f) const;
+
+    template <typename F>
+    void gather(CandidateBatch &batch, Real radius, int node, int begin, int end, int level, F &f) const;
+
 public:
-    using NodePtr = std::shared_ptr<Node>;
+    constexpr static int bucket_size = 8;
 
-    NodePtr left, right;
-    Particle *particle;
-    bool vertical;
+    KDTree();
 
-    Node(Particle *particle, bool vertical, const NodePtr &left, const NodePtr &right);
+    void build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool);
 
-    ~Node();
+    template <typename F>
+    void for_each_candidate_range(int query, Real radius, F &&f) const;
 
-    bool isLeaf() const;
+    template <typename F>
+    void for_each_batch(Real radius, F &&f) const;
 };
 
-class KDTree
+// Calls f(candidates, n) for every leaf bucket in reach of the query,
+// candidates being the n particles in it.
+template <typename F>
+void KDTree::for_each_candidate_range(int query, Real radius, F &&f) const
 {
-private:
-    float width, height;
+    if (order.empty())
+        return;
 
-    Node::NodePtr root;
+    PeriodicQuery periodic(particles->position(query), radius, width, height);
+    visit(periodic, periodic.all_images(), 0, 0, static_cast<int>(order.size()), 0, f);
+}
 
-    Node::NodePtr insert(const Node::NodePtr &node, Particle *particle, bool vertical);
+template <typename F>
+void KDTree::visit(const PeriodicQuery &query, unsigned images, int node, int begin, int end, int level, F &f) const
+{
+    // Every particle sits in exactly one leaf and each leaf is reached at most once, whichever images lead to it.
+    if (level == depth)
+    {
+        f(order.data() + begin, end - begin);
+        return;
+    }
 
-    void search(Particle *query, double radius, const Node::NodePtr &node, std::vector<Particle *> &results) const;
+    unsigned left = 0, right = 0;
+    for (int i = 0; i < query.n_images; i++)
+    {
+        if (!(images & (1u << i)))
+            continue;
 
-public:
-    KDTree(float width, float height);
+        Real q = nodes[node].vertical ? query.images[i].x : query.images[i].y;
+        if (q - query.radius <= nodes[node].split)
+            left |= 1u << i;
+        if (q + query.radius >= nodes[node].split)
+            right |= 1u << i;
+    }
 
-    void insert(Particle *particle);
+    int mid = begin + (end - begin) / 2;
+    if (left)
+        visit(query, left, 2 * node + 1, begin, mid, level + 1, f);
+    if (right)
+        visit(query, right, 2 * node + 2, mid, end, level + 1, f);
+}
 
-    std::vector<Particle *> search(Particle *query, double radius) const;
-};
+// Calls f(batch) once per leaf bucket. The tree is walked once for the whole
+// bucket, and the batch answers each query's neighbours within radius.
+template <typename F>
+void KDTree::for_each_batch(Real radius, F &&f) const
+{
+    if (order.empty())
+        return;
+
+    CandidateBatch batch(*particles, width, height);
+    gather(batch, radius, 0, 0, static_cast<int>(order.size()), 0, f);
+}
+
+template <typename F>
+void KDTree::gather(CandidateBatch &batch, Real radius, int node, int begin, int end, int level, F &f) const
+{
+    if (level < depth)
+    {
+        int mid = begin + (end - begin) / 2;
+        gather(batch, radius, 2 * node + 1, begin, mid, level + 1, f);
+        gather(batch, radius, 2 * node + 2, mid, end, level + 1, f);
+        return;
+    }
+
+    if (begin == end)
+        return;
+
+    batch.gather(order.data() + begin, end - begin, radius, [&](const PeriodicQuery &bounds, auto &collect) {
+        visit(bounds, bounds.all_images(), 0, 0, static_cast<int>(order.size()), 0, collect);
+    });
+
+    f(static_cast<const CandidateBatch &>(batch));
+}
 
 #endif
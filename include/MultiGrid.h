@@ -0,0 +1,65 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef MultiGrid_H
+#define MultiGrid_H
+
+#include <vector>
+#include "CellGrid.h"
+
+// One CellGrid per class of query radii. Species whose radii are within a
+// small factor of each other share a level whose cells fit the largest of
+// them, so short-sighted species do not scan cells sized for long-sighted ones.
+class MultiGrid : public SpatialIndex<MultiGrid>
+{
+private:
+    std::vector<CellGrid> levels;
+    std::vector<int> species_level;
+    const ParticleStore *particles = nullptr;
+    std::vector<Real> radii;
+    bool incremental = false;
+
+public:
+    constexpr static Real level_ratio = 1.5;
+
+    // Free slots per cell of an incremental grid.
+    constexpr static int incremental_slack = 4;
+
+    explicit MultiGrid(bool incremental = false);
+
+    void build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool);
+
+    bool update(const std::vector<Real> &radii, ThreadPool &pool);
+
+    template <typename F>
+    void for_each_candidate_range(int query, Real radius, F &&f) const;
+
+    template <typename F>
+    void for_each_neighbor(int query, Real radius, F &&f) const;
+
+    template <typename F>
+    void for_each_pair(Real radius, F &&f) const;
+};
+
+// The query is answered by the level of its species.
+template <typename F>
+void MultiGrid::for_each_candidate_range(int query, Real radius, F &&f) const
+{
+    levels[species_level[particles->species[query]]].for_each_candidate_range(query, radius, f);
+}
+
+template <typename F>
+void MultiGrid::for_each_neighbor(int query, Real radius, F &&f) const
+{
+    levels[species_level[particles->species[query]]].for_each_neighbor(query, radius, f);
+}
+
+// The last level has the largest cells, so it covers any radius used by a species.
+template <typename F>
+void MultiGrid::for_each_pair(Real radius, F &&f) const
+{
+    levels.back().for_each_pair(radius, f);
+}
+
+#endif
@@ -0,0 +1,66 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef NeighborKernel_H
+#define NeighborKernel_H
+
+#include <cstdint>
+#include "Vector2D.h"
+
+// Neighbours seen by one particle during a step, split by which side of its
+// heading (cos c, sin s) they are on.
+struct Neighborhood
+{
+    int left = 0, right = 0, close = 0;
+
+    void add(const Vector2D &offset, Real c, Real s)
+    {
+        if (offset.length2() < Real(1.3 * 1.3))
+            close++;
+
+        Real y = (c * offset.y) - (s * offset.x);
+        (y > 0) ? left++ : right++;
+    }
+};
+
+enum class KernelIsa
+{
+    automatic,
+    scalar,
+    avx2,
+    avx512
+};
+
+// One particle looking for its neighbours: its position and heading (c, s),
+// the squared perception radius and the area it wraps around in. Quantized
+// queries also carry the packed position and the size of one step per axis.
+struct NeighborQuery
+{
+    Real x, y;
+    Real c, s;
+    Real radius2;
+    Real width, height;
+    int self;
+    std::uint32_t packed = 0;
+    Real unit_x = 0, unit_y = 0;
+};
+
+// Both kernels add the candidates candidates[k] for k < n that are within the
+// query's radius, other than the query itself, to neighborhood. The first
+// reads Real positions, the second 16-bit torus coordinates packed as
+// x | y << 16, for which the minimum-image delta is a wrapping subtraction.
+struct NeighborKernel
+{
+    void (*classify)(const NeighborQuery &query, const Real *x, const Real *y, const int *candidates, int n, Neighborhood &neighborhood);
+    void (*classify_quantized)(const NeighborQuery &query, const std::uint32_t *packed, const int *candidates, int n, Neighborhood &neighborhood);
+};
+
+// Widest instruction set the running CPU supports. The SIMD kernels are
+// float only, so the double build always reports the scalar one.
+KernelIsa best_isa();
+
+// The kernel for isa, or for the widest supported one below it.
+NeighborKernel neighbor_kernel(KernelIsa isa);
+
+#endif
@@ -7,12 +7,54 @@
 #define ParticleManager_H
 
 #include <vector>
+#include <variant>
+#include <memory>
 #include "Particle.h"
+#include "ParticleStore.h"
+#include "MultiGrid.h"
+#include "HaloGrid.h"
+#include "HashGrid.h"
+#include "KDTree.h"
+#include "QuadTree.h"
+#include "VerletList.h"
 #include "SpeciesProperties.h"
+#include "SpeciesTable.h"
+#include "StepOptions.h"
+#include "ThreadPool.h"
+#include "CountingSort.h"
 
 class ParticleManager {
 private:
-    std::vector<Particle> particles;
+    ParticleStore particles;
+    std::variant<MultiGrid, HaloGrid, HashGrid, KDTree, QuadTree> spatial_index;
+    std::vector<Real> radii;
+    SpeciesTable species_table;
+    VerletList verlet;
+    StepOptions options;
+    std::unique_ptr<ThreadPool> pool = std::make_unique<ThreadPool>(1);
+    NeighborKernel kernel = neighbor_kernel(KernelIsa::automatic);
+    std::vector<Neighborhood> neighborhoods;
+    std::vector<PopulationCounts> populations;
+    std::vector<PopulationCounts> chunk_populations;
+    std::vector<int> tile_of;
+    CountingSort tiles;
+    int index_age = 0;
+
+    template <typename Index>
+    void refresh(Index &index, const Real simulation_width, const Real simulation_height);
+
+    template <typename Index, typename Species>
+    void step(const Index &index, const Real simulation_width, const Real simulation_height, const Species &species);
+
+    constexpr static int tiles_per_thread = 16;
+
+    void tile(const Real simulation_width, const Real simulation_height);
+
+    template <typename Species>
+    void advance(const Real simulation_width, const Real simulation_height, const Species &species);
+
+    template <typename Index, typename Species>
+    void update_pairs(Index &index, const Real simulation_width, const Real simulation_height, const Species &species);
 
 public:
 
@@ -24,9 +66,17 @@ public:
 
     Particle operator[](int i) const;
 
+    const ParticleStore &store() const;
+
     void add(const Particle &particle);
 
-    void update(const float simulation_width, const float simulation_height, const std::vector<SpeciesProperties> species);
+    void set_options(const StepOptions &options);
+
+    void reorder(const Real simulation_width, const Real simulation_height, std::vector<int> &permutation);
+
+    void update(const Real simulation_width, const Real simulation_height, const std::vector<SpeciesProperties> &species);
+
+    const std::vector<PopulationCounts> &population_counts() const;
 
     int size() const;
 
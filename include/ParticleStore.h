@@ -0,0 +1,133 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef ParticleStore_H
+#define ParticleStore_H
+
+#include <vector>
+#include <cmath>
+#include "Particle.h"
+#include "Vector2D.h"
+#include "AlignedAllocator.h"
+#include "NeighborKernel.h"
+#include "HeadingTable.h"
+#include "SpeciesTable.h"
+#include "Population.h"
+
+// The particles as a structure of arrays. Particle i is the i-th entry of
+// every array, so a neighbour scan only streams the coordinates it reads.
+// Spatial indices refer to particles by their index in the store. Headings
+// are fixed point, and their cosine and sine are kept next to them so they
+// are evaluated once per turn. Quantized stores also keep every position as
+// 16-bit torus coordinates that wrap on overflow, and derive x and y from them.
+class ParticleStore
+{
+private:
+    HeadingTable table;
+    Real unit_x = 0, unit_y = 0;
+
+    void update_direction(int i);
+
+    void snap(int i);
+
+public:
+    AlignedVector<Real> x, y;
+    AlignedVector<std::uint32_t> heading;
+    AlignedVector<Real> heading_cos, heading_sin;
+    AlignedVector<int> species;
+    AlignedVector<int> n_neighbors;
+    AlignedVector<int> n_close_neighbors;
+    AlignedVector<Population> population;
+    AlignedVector<std::uint32_t> packed;
+
+    ParticleStore();
+
+    Particle operator[](int i) const;
+
+    int size() const;
+
+    void add(const Particle &particle);
+
+    void permute(const std::vector<int> &permutation);
+
+    void set_heading_table(const HeadingTable &table);
+
+    void quantize(Real width, Real height);
+
+    bool quantized() const;
+
+    // Read on every neighbour visit, so it stays inline.
+    Vector2D position(int i) const
+    {
+        return Vector2D(x[i], y[i]);
+    }
+
+    Real angle(int i) const;
+
+    template <typename Index>
+    Neighborhood neighborhood(int i, const Index &index, const SpeciesKernel &species) const;
+
+    template <typename Index>
+    Neighborhood neighborhood(int i, const Index &index, const NeighborKernel &kernel, const Real width, const Real height, const SpeciesKernel &species) const;
+
+    template <typename Index>
+    void update_phi(int i, const Index &index, const NeighborKernel &kernel, const Real width, const Real height, const SpeciesKernel &species);
+
+    void turn(int i, const Neighborhood &neighborhood, const SpeciesKernel &species);
+
+    void move(int i, const Real width, const Real height, const Real speed);
+};
+
+// Consumes the neighbours of particle i straight from the index, without collecting them first.
+template <typename Index>
+Neighborhood ParticleStore::neighborhood(int i, const Index &index, const SpeciesKernel &species) const
+{
+    Neighborhood neighborhood;
+    index.for_each_neighbor(i, species.perception, [&](int other, const Vector2D &offset) {
+        if (other != i)
+            neighborhood.add(offset, heading_cos[i], heading_sin[i]);
+    });
+    return neighborhood;
+}
+
+// Hands the index's candidates to the kernel a range at a time, so they are classified several
+// per instruction. Indices without candidate ranges fall back to the visitor above.
+template <typename Index>
+Neighborhood ParticleStore::neighborhood(int i, const Index &index, const NeighborKernel &kernel, const Real width, const Real height, const SpeciesKernel &species) const
+{
+    if constexpr (requires { index.for_each_candidate_range(i, species.perception, [](const int *, int) {}); })
+    {
+        Neighborhood neighborhood;
+        NeighborQuery query{x[i], y[i], heading_cos[i], heading_sin[i], species.perception2, width, height, i};
+
+        if (quantized())
+        {
+            query.packed = packed[i];
+            query.unit_x = unit_x;
+            query.unit_y = unit_y;
+            index.for_each_candidate_range(i, species.perception, [&](const int *candidates, int n) {
+                kernel.classify_quantized(query, packed.data(), candidates, n, neighborhood);
+            });
+        }
+        else
+        {
+            index.for_each_candidate_range(i, species.perception, [&](const int *candidates, int n) {
+                kernel.classify(query, x.data(), y.data(), candidates, n, neighborhood);
+            });
+        }
+        return neighborhood;
+    }
+    else
+    {
+        return this->neighborhood(i, index, species);
+    }
+}
+
+template <typename Index>
+void ParticleStore::update_phi(int i, const Index &index, const NeighborKernel &kernel, const Real width, const Real height, const SpeciesKernel &species)
+{
+    turn(i, neighborhood(i, index, kernel, width, height, species), species);
+}
+
+#endif
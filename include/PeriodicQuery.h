@@ -0,0 +1,27 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef PeriodicQuery_H
+#define PeriodicQuery_H
+
+#include "Vector2D.h"
+
+// The periodic images of a query disk that overlap the [0, width) x
+// [0, height) simulation area. Tree indices descend with a mask of the images
+// still live in a subtree, so a single traversal serves all of them. A disk
+// wider than the area crosses both borders of an axis and needs an image on
+// either side, so there are at most three per axis.
+struct PeriodicQuery
+{
+    Vector2D position;
+    Vector2D images[9];
+    int n_images = 0;
+    Real radius;
+
+    PeriodicQuery(const Vector2D &position, Real radius, Real width, Real height);
+
+    unsigned all_images() const;
+};
+
+#endif
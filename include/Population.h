@@ -0,0 +1,57 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef Population_H
+#define Population_H
+
+#include <array>
+#include <algorithm>
+#include <cstdint>
+
+// How crowded a particle's surroundings are, in the order the log reports them.
+enum class Population : std::uint8_t
+{
+    yellow,  // Nt,r=5 > 35
+    blue,    // 15 < Nt,r=5 ≤ 35
+    brown,   // 13 ≤ Nt,r=5 ≤ 15
+    magenta, // Nt,r=1.3 > 15, before any of the above
+    green    // everything else
+};
+
+constexpr int n_populations = 5;
+
+using PopulationCounts = std::array<int, n_populations>;
+
+// Counts past these all fall in the same population.
+constexpr int population_neighbors = 36, population_close_neighbors = 16;
+
+constexpr std::array<Population, (population_neighbors + 1) * (population_close_neighbors + 1)> population_table = [] {
+    std::array<Population, (population_neighbors + 1) * (population_close_neighbors + 1)> table{};
+    for (int close = 0; close <= population_close_neighbors; close++)
+    {
+        for (int n = 0; n <= population_neighbors; n++)
+        {
+            Population &population = table[close * (population_neighbors + 1) + n];
+            if (close > 15)
+                population = Population::magenta;
+            else if (15 < n && n <= 35)
+                population = Population::blue;
+            else if (n > 35)
+                population = Population::yellow;
+            else if (13 <= n && n <= 15)
+                population = Population::brown;
+            else
+                population = Population::green;
+        }
+    }
+    return table;
+}();
+
+// The population of a particle with the given neighbour counts, looked up rather than branched on.
+inline Population classify_population(int n_neighbors, int n_close_neighbors)
+{
+    return population_table[std::min(n_close_neighbors, population_close_neighbors) * (population_neighbors + 1) + std::min(n_neighbors, population_neighbors)];
+}
+
+#endif
@@ -0,0 +1,129 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef QuadTree_H
+#define QuadTree_H
+
+#include <vector>
+#include <algorithm>
+#include "ParticleStore.h"
+#include "PeriodicQuery.h"
+#include "SpatialIndex.h"
+#include "CandidateBatch.h"
+#include "ThreadPool.h"
+
+// Region quadtree whose nodes split into quadrants while they hold more than
+// `leaf_capacity` particles. Dense spores and cells just get deeper subtrees,
+// so no leaf scan grows with the local density. Nodes are stored breadth
+// first with their four children next to each other, and each node owns a
+// contiguous range of `order`.
+class QuadTree : public SpatialIndex<QuadTree>
+{
+private:
+    friend class SpatialIndex<QuadTree>;
+
+    struct Node
+    {
+        Real min_x, min_y, max_x, max_y;
+        int begin, end;
+        int children;
+        int depth;
+    };
+
+    Real width = 0, height = 0;
+
+    const ParticleStore *particles = nullptr;
+    std::vector<int> order;
+    std::vector<Node> nodes;
+
+    void split(int node);
+
+    template <typename F>
+    void visit(const PeriodicQuery &query, unsigned images, int node, F &f) const;
+
+public:
+    constexpr static int leaf_capacity = 8;
+    constexpr static int max_depth = 24;
+
+    QuadTree();
+
+    void build(const ParticleStore &particles, Real width, Real height);
+
+    void build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool);
+
+    template <typename F>
+    void for_each_candidate_range(int query, Real radius, F &&f) const;
+
+    template <typename F>
+    void for_each_batch(Real radius, F &&f) const;
+};
+
+// Calls f(candidates, n) for every leaf in reach of the query, candidates
+// being the n particles in it.
+template <typename F>
+void QuadTree::for_each_candidate_range(int query, Real radius, F &&f) const
+{
+    if (order.empty())
+        return;
+
+    PeriodicQuery periodic(particles->position(query), radius, width, height);
+    visit(periodic, periodic.all_images(), 0, f);
+}
+
+template <typename F>
+void QuadTree::visit(const PeriodicQuery &query, unsigned images, int node, F &f) const
+{
+    const Node &current = nodes[node];
+
+    if (current.children < 0)
+    {
+        f(order.data() + current.begin, current.end - current.begin);
+        return;
+    }
+
+    for (int child = current.children; child < current.children + 4; child++)
+    {
+        const Node &quadrant = nodes[child];
+        if (quadrant.begin == quadrant.end)
+            continue;
+
+        // Keep the images whose disk reaches into the quadrant.
+        unsigned overlapping = 0;
+        for (int i = 0; i < query.n_images; i++)
+        {
+            if (!(images & (1u << i)))
+                continue;
+
+            Real dx = std::max({quadrant.min_x - query.images[i].x, Real(0), query.images[i].x - quadrant.max_x});
+            Real dy = std::max({quadrant.min_y - query.images[i].y, Real(0), query.images[i].y - quadrant.max_y});
+            if (dx * dx + dy * dy <= query.radius * query.radius)
+                overlapping |= 1u << i;
+        }
+
+        if (overlapping)
+            visit(query, overlapping, child, f);
+    }
+}
+
+// Calls f(batch) once per non-empty leaf. The tree is walked once for the
+// whole leaf, and the batch answers each query's neighbours within radius.
+template <typename F>
+void QuadTree::for_each_batch(Real radius, F &&f) const
+{
+    CandidateBatch batch(*particles, width, height);
+
+    for (const Node &leaf : nodes)
+    {
+        if (leaf.children >= 0 || leaf.begin == leaf.end)
+            continue;
+
+        batch.gather(order.data() + leaf.begin, leaf.end - leaf.begin, radius, [&](const PeriodicQuery &bounds, auto &collect) {
+            visit(bounds, bounds.all_images(), 0, collect);
+        });
+
+        f(static_cast<const CandidateBatch &>(batch));
+    }
+}
+
+#endif
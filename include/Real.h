@@ -0,0 +1,16 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef Real_H
+#define Real_H
+
+// Scalar type of the physics core. Builds are all-float by default; defining
+// URSOUP_DOUBLE gives the all-double reference build.
+#ifdef URSOUP_DOUBLE
+using Real = double;
+#else
+using Real = float;
+#endif
+
+#endif
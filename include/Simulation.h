@@ -15,6 +15,7 @@
 #include <SFML/Graphics.hpp>
 #include "ParticleManager.h"
 #include "SpeciesProperties.h"
+#include "StepOptions.h"
 
 class Simulation
 {
@@ -28,8 +29,9 @@ private:
     int _m_window_width, _m_window_height;
     int _m_simulation_width, _m_simulation_height;
     std::vector<SpeciesProperties> _m_species;
-    std::vector<std::vector<int>> _m_population_count;
+    std::vector<PopulationCounts> _m_population_count;
     ParticleManager _m_particle_manager;
+    StepOptions _m_step_options;
     std::vector<sf::CircleShape> _m_shapes;
     bool _m_use_light_scheme;
     bool _m_log_screenshot;
@@ -41,6 +43,7 @@ private:
     bool _m_is_headless = false;
     void _add_particle(float x, float y, int species);
     void _update();
+    void _reorder();
     void _render();
     void _log() const;
     void _reset_population_count();
@@ -48,7 +51,7 @@ private:
     bool _handle_input(std::shared_ptr<sf::RenderWindow> window);
     float static _get_random_float();
     float _scale() const;
-    sf::Color _neighborhood_color(const Particle& particle);
+    sf::Color static _neighborhood_color(Population population);
 
     void _try_log();
 
@@ -68,7 +71,7 @@ public:
     constexpr static std::string_view default_config_file = "config.ini";
     constexpr static std::string_view default_log_file = "log.csv";
     constexpr static float default_particle_density = 0.08;
-    Simulation(std::vector<SpeciesProperties> species, int window_width, int window_height, int simulation_width, int simulation_height, float draw_size, int log_interval, std::string log_file, int exit_after, bool headless = false, bool fullscreen = false, bool light_scheme = false, bool log_screenshot = false);
+    Simulation(std::vector<SpeciesProperties> species, int window_width, int window_height, int simulation_width, int simulation_height, float draw_size, int log_interval, std::string log_file, int exit_after, bool headless = false, bool fullscreen = false, bool light_scheme = false, bool log_screenshot = false, StepOptions step_options = StepOptions());
     ~Simulation();
     void run(float particle_density);
 };
@@ -0,0 +1,21 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef SpaceFillingCurve_H
+#define SpaceFillingCurve_H
+
+#include <cstdint>
+#include "Vector2D.h"
+
+enum class SpaceFillingCurve
+{
+    morton,
+    hilbert
+};
+
+// Position along the curve of a point in the [0, width) x [0, height) area,
+// quantized to 16 bits per axis.
+std::uint32_t curve_key(SpaceFillingCurve curve, const Vector2D &position, Real width, Real height);
+
+#endif
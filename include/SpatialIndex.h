@@ -0,0 +1,104 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef SpatialIndex_H
+#define SpatialIndex_H
+
+#include <vector>
+#include "ParticleStore.h"
+
+enum class SpatialBackend
+{
+    grid,
+    hash,
+    kdtree,
+    quadtree
+};
+
+// Queries shared by every spatial index. An index whose candidates sit in
+// contiguous runs of particle indices provides
+//
+//     template <typename F> void for_each_candidate_range(int query, Real radius, F &&f) const;
+//
+// calling f(const int *candidates, int n) with unfiltered runs that hold every
+// particle within radius of particle `query`, along with the members
+// `particles`, `width` and `height`, and gets
+//
+//     template <typename F> void for_each_neighbor(int query, Real radius, F &&f) const;
+//
+// from here, which calls f(int other, const Vector2D &offset) for each of them.
+// An index that cannot hand out runs, or measures offsets differently, provides
+// for_each_neighbor itself. The collecting and counting queries are built on
+// for_each_neighbor, and particles are referred to by their index in the
+// ParticleStore. The backends ParticleManager can select also provide
+//
+//     void build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool);
+//
+// where radii[s] is the largest radius species s will query with and pool
+// runs the parallel parts of the build. The candidate runs also let a
+// NeighborKernel test several candidates at once. A backend is picked once and then
+// used through its concrete type, so nothing on the per-neighbour path goes
+// through a virtual call.
+template <typename Index>
+class SpatialIndex
+{
+public:
+    template <typename F>
+    void for_each_neighbor(int query, Real radius, F &&f) const;
+
+    std::vector<int> search(int query, Real radius) const;
+
+    void search(int query, Real radius, std::vector<int> &results) const;
+
+    int count(int query, Real radius) const;
+};
+
+// Calls f(particle, offset) for every particle within radius of the query,
+// offset being the minimum-image displacement from the query to it.
+template <typename Index>
+template <typename F>
+void SpatialIndex<Index>::for_each_neighbor(int query, Real radius, F &&f) const
+{
+    const Index &index = static_cast<const Index &>(*this);
+    Vector2D position = index.particles->position(query);
+    index.for_each_candidate_range(query, radius, [&](const int *candidates, int n) {
+        for (int k = 0; k < n; k++)
+        {
+            Vector2D offset = position.toroidal_offset(index.particles->position(candidates[k]), index.width, index.height);
+            if (offset.length2() < radius * radius)
+                f(candidates[k], offset);
+        }
+    });
+}
+
+template <typename Index>
+std::vector<int> SpatialIndex<Index>::search(int query, Real radius) const
+{
+    std::vector<int> results;
+    search(query, radius, results);
+    return results;
+}
+
+// Fills a caller-owned buffer, which keeps its capacity between queries.
+template <typename Index>
+void SpatialIndex<Index>::search(int query, Real radius, std::vector<int> &results) const
+{
+    results.clear();
+    static_cast<const Index &>(*this).for_each_neighbor(query, radius, [&results](int particle, const Vector2D &) {
+        results.push_back(particle);
+    });
+}
+
+// Counts what search would return, the query itself included.
+template <typename Index>
+int SpatialIndex<Index>::count(int query, Real radius) const
+{
+    int n = 0;
+    static_cast<const Index &>(*this).for_each_neighbor(query, radius, [&n](int, const Vector2D &) {
+        n++;
+    });
+    return n;
+}
+
+#endif
@@ -6,16 +6,17 @@
 #define SpeciesProperties_H
 
 #include <SFML/Graphics.hpp>
+#include "Real.h"
 
 struct SpeciesProperties
 {
-    float speed;
-    float perception;
-    float alpha;
-    float beta;
+    Real speed;
+    Real perception;
+    Real alpha;
+    Real beta;
     sf::Color color;
 
-    SpeciesProperties(float speed, float perception, float alpha, float beta, sf::Color color)
+    SpeciesProperties(Real speed, Real perception, Real alpha, Real beta, sf::Color color)
         : speed{speed}, perception{perception}, alpha{alpha}, beta{beta}, color{color}{};
 };
 
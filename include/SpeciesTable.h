@@ -0,0 +1,112 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef SpeciesTable_H
+#define SpeciesTable_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "Real.h"
+#include "AlignedAllocator.h"
+
+struct SpeciesProperties;
+
+// What a step needs to know about one species. The turn rates are prescaled
+// to fixed point headings, so turning a particle is integer arithmetic.
+struct alignas(32) SpeciesKernel
+{
+    Real speed = 0;
+    Real perception = 0;
+    Real perception2 = 0;
+    std::uint32_t alpha = 0;
+    std::uint32_t beta = 0;
+};
+
+// The SpeciesKernel of every species, without any of the rendering data.
+class SpeciesTable
+{
+private:
+    AlignedVector<SpeciesKernel> kernels;
+    Real largest_perception = 0;
+
+public:
+    SpeciesTable();
+
+    explicit SpeciesTable(const std::vector<SpeciesProperties> &species);
+
+    const SpeciesKernel &operator[](int species) const
+    {
+        return kernels[species];
+    }
+
+    int size() const;
+
+    Real max_perception() const;
+};
+
+// A SpeciesTable with the number of species fixed at compile time. It is held
+// by value, and with a single species the lookup disappears altogether.
+template <int N>
+class FixedSpeciesTable
+{
+private:
+    std::array<SpeciesKernel, N> kernels;
+    Real largest_perception;
+
+public:
+    explicit FixedSpeciesTable(const SpeciesTable &table);
+
+    const SpeciesKernel &operator[](int species) const
+    {
+        if constexpr (N == 1)
+            return kernels[0];
+        else
+            return kernels[species];
+    }
+
+    constexpr int size() const
+    {
+        return N;
+    }
+
+    Real max_perception() const
+    {
+        return largest_perception;
+    }
+};
+
+template <int N>
+FixedSpeciesTable<N>::FixedSpeciesTable(const SpeciesTable &table) : largest_perception{table.max_perception()}
+{
+    for (int s = 0; s < N; s++)
+        kernels[s] = table[s];
+}
+
+// Calls f with a FixedSpeciesTable when there are one to four species, and
+// with the table itself otherwise.
+template <typename F>
+void with_fixed_species(const SpeciesTable &table, F &&f)
+{
+    switch (table.size())
+    {
+    case 1:
+        f(FixedSpeciesTable<1>(table));
+        break;
+    case 2:
+        f(FixedSpeciesTable<2>(table));
+        break;
+    case 3:
+        f(FixedSpeciesTable<3>(table));
+        break;
+    case 4:
+        f(FixedSpeciesTable<4>(table));
+        break;
+    default:
+        f(table);
+        break;
+    }
+}
+
+#endif
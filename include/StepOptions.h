@@ -0,0 +1,60 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef StepOptions_H
+#define StepOptions_H
+
+#include "Real.h"
+#include "SpaceFillingCurve.h"
+#include "SpatialIndex.h"
+#include "NeighborKernel.h"
+
+// Optional changes to how ParticleManager advances the simulation.
+struct StepOptions
+{
+    // Extra radius kept in the Verlet neighbour lists, 0 disables them.
+    Real verlet_skin = 0;
+
+    // Sort the particle storage along a space-filling curve every this many steps, 0 never does.
+    int reorder_interval = 0;
+    SpaceFillingCurve reorder_curve = SpaceFillingCurve::hilbert;
+
+    // Visit every pair of neighbours once and update both sides. All particles turn and move after
+    // every pair has been seen, so the step reads only the previous state.
+    bool pair_traversal = false;
+
+    // Gather every particle's neighbourhood from the previous state before any of them turns or
+    // moves, so the result does not depend on the order the particles are visited in.
+    bool synchronous = false;
+
+    // Structure answering the neighbour queries.
+    SpatialBackend index = SpatialBackend::grid;
+
+    // Let tree backends answer the queries of a whole leaf bucket with one traversal.
+    bool batched_queries = false;
+
+    // Pad the grid backend with copies of the border particles so queries never wrap.
+    bool ghost_halo = false;
+
+    // Keep the grid's cell membership between steps and only move the particles that changed
+    // cell, building it from scratch every this many steps. 0 builds it every step.
+    int cell_rebuild_interval = 0;
+
+    // Instruction set of the neighbour classification, automatic picks the widest the CPU has.
+    KernelIsa kernel = KernelIsa::automatic;
+
+    // Read headings' cosine and sine from a table of 2^bits entries, 0 computes them exactly.
+    int heading_table_bits = 0;
+
+    // Keep positions as 16-bit torus coordinates whose wrap is integer overflow. The world is
+    // resolved into 65536 steps per axis, exactly so for power-of-two sizes, and moves are rounded
+    // to whole steps, so a step has to be small next to every species' speed.
+    bool quantized_positions = false;
+
+    // Threads used by the step, 0 uses one per hardware thread. Index builds always use them; the
+    // neighbour queries and the moves only in synchronous steps, which do not depend on order.
+    int threads = 0;
+};
+
+#endif
@@ -0,0 +1,77 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef ThreadPool_H
+#define ThreadPool_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <functional>
+
+// Persistent worker threads. run() gives the workers and the calling thread
+// one contiguous share of the task indices each. Every thread works through
+// its share from the front, and a thread that runs out steals the back half
+// of another's, so uneven tasks still keep all of them busy. run() returns
+// once every task is done.
+class ThreadPool
+{
+private:
+    // A thread's remaining tasks [begin, end), packed into one word so the owner
+    // and the thieves can both update it with a single compare-and-swap.
+    struct alignas(64) Share
+    {
+        std::atomic<std::uint64_t> bounds{0};
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Share[]> shares;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    const std::function<void(int)> *task = nullptr;
+    int busy = 0;
+    unsigned generation = 0;
+    bool stopping = false;
+
+    void work(int thread);
+
+    void drain(int thread);
+
+    bool take(int thread, int &i);
+
+    bool steal(int thread, int &i);
+
+public:
+    // 0 threads uses one per hardware thread.
+    explicit ThreadPool(int n_threads = 0);
+
+    ThreadPool(const ThreadPool &other) = delete;
+
+    ~ThreadPool();
+
+    ThreadPool &operator=(const ThreadPool &other) = delete;
+
+    int size() const;
+
+    void run(int n_tasks, const std::function<void(int)> &task);
+
+    template <typename F>
+    void for_each_chunk(int n, F &&f);
+};
+
+// Splits [0, n) into one contiguous chunk per thread and runs f(chunk, begin, end) on each.
+template <typename F>
+void ThreadPool::for_each_chunk(int n, F &&f)
+{
+    int n_chunks = size();
+    run(n_chunks, [&](int chunk) {
+        f(chunk, static_cast<int>(static_cast<long long>(n) * chunk / n_chunks), static_cast<int>(static_cast<long long>(n) * (chunk + 1) / n_chunks));
+    });
+}
+
+#endif
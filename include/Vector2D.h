@@ -5,82 +5,334 @@
 #ifndef BOIDS_VECTOR2D_H
 #define BOIDS_VECTOR2D_H
 
-
-class Vector2D {
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include "Real.h"
+
+// Two-component vector over the scalar type T. The physics core uses Vector2D,
+// which is instantiated over the build's Real. Everything is defined here, so
+// the arithmetic inlines into the neighbour loops.
+template <typename T>
+class BasicVector2D {
 private:
 
-    float static get_random_float();
+    T static get_random_float();
 
 public:
-    float x, y;
+    T x, y;
 
     // Constructors
-    explicit Vector2D(float x = 0, float y = 0);
+    constexpr explicit BasicVector2D(T x = 0, T y = 0);
 
-    Vector2D(const Vector2D &other);
+    constexpr BasicVector2D(const BasicVector2D &other) = default;
 
-    ~Vector2D();
+    constexpr ~BasicVector2D() = default;
 
     // Operators
-    Vector2D &operator=(const Vector2D &other);
+    constexpr BasicVector2D &operator=(const BasicVector2D &other) = default;
 
-    Vector2D &operator=(float scalar);
+    constexpr BasicVector2D &operator=(T scalar);
 
-    Vector2D operator+(const Vector2D &other) const;
+    constexpr BasicVector2D operator+(const BasicVector2D &other) const;
 
-    Vector2D operator-(const Vector2D &other) const;
+    constexpr BasicVector2D operator-(const BasicVector2D &other) const;
 
-    Vector2D operator+(float scalar) const;
+    constexpr BasicVector2D operator+(T scalar) const;
 
-    Vector2D operator-(float scalar) const;
+    constexpr BasicVector2D operator-(T scalar) const;
 
-    Vector2D &operator+=(const Vector2D &other);
+    constexpr BasicVector2D &operator+=(const BasicVector2D &other);
 
-    Vector2D &operator-=(const Vector2D &other);
+    constexpr BasicVector2D &operator-=(const BasicVector2D &other);
 
-    Vector2D &operator+=(float scalar);
+    constexpr BasicVector2D &operator+=(T scalar);
 
-    Vector2D &operator-=(float scalar);
+    constexpr BasicVector2D &operator-=(T scalar);
 
-    Vector2D operator*(const Vector2D &other) const;
+    constexpr BasicVector2D operator*(const BasicVector2D &other) const;
 
-    Vector2D operator*(float scalar) const;
+    constexpr BasicVector2D operator*(T scalar) const;
 
-    Vector2D &operator*=(const Vector2D &other);
+    constexpr BasicVector2D &operator*=(const BasicVector2D &other);
 
-    Vector2D &operator*=(float scalar);
+    constexpr BasicVector2D &operator*=(T scalar);
 
-    Vector2D operator/(const Vector2D &other) const;
+    constexpr BasicVector2D operator/(const BasicVector2D &other) const;
 
-    Vector2D operator/(float scalar) const;
+    constexpr BasicVector2D operator/(T scalar) const;
 
-    Vector2D &operator/=(const Vector2D &other);
+    constexpr BasicVector2D &operator/=(const BasicVector2D &other);
 
-    Vector2D &operator/=(float scalar);
+    constexpr BasicVector2D &operator/=(T scalar);
 
-    bool operator==(const Vector2D &other) const;
+    constexpr bool operator==(const BasicVector2D &other) const;
 
-    bool operator!=(const Vector2D &other) const;
+    constexpr bool operator!=(const BasicVector2D &other) const;
 
-    Vector2D &operator-();
+    constexpr BasicVector2D operator-() const;
 
     // Methods
-    float distance(const Vector2D &other) const;
+    T distance(const BasicVector2D &other) const;
+
+    constexpr BasicVector2D toroidal_offset(const BasicVector2D &other, T width, T height) const;
 
-    float toroidal_distance2(const Vector2D &other, float width, float height) const;
+    constexpr T toroidal_distance2(const BasicVector2D &other, T width, T height) const;
 
-    float toroidal_distance(const Vector2D &other, float width, float height) const;
+    T toroidal_distance(const BasicVector2D &other, T width, T height) const;
 
-    float norm() const;
+    T norm() const;
 
-    float length2() const;
+    constexpr T length2() const;
 
-    Vector2D &normalize();
+    BasicVector2D &normalize();
 
-    Vector2D &limit(float max);
+    BasicVector2D &limit(T max);
 
-    static Vector2D random();
+    static BasicVector2D random();
 };
 
+using Vector2D = BasicVector2D<Real>;
+
+static_assert(std::is_trivially_copyable_v<Vector2D>);
+
+// Minimum-image offsets from origin to the n points (x[k], y[k]), written to
+// dx[k] and dy[k]. The loop has no calls or dependencies, so it vectorizes.
+template <typename T>
+constexpr void toroidal_offsets(const BasicVector2D<T> &origin, const T *x, const T *y, int n, T width, T height, T *dx, T *dy)
+{
+    for (int k = 0; k < n; k++)
+    {
+        BasicVector2D<T> offset = origin.toroidal_offset(BasicVector2D<T>(x[k], y[k]), width, height);
+        dx[k] = offset.x;
+        dy[k] = offset.y;
+    }
+}
+
+// Squared minimum-image distances from origin to the n points (x[k], y[k]).
+template <typename T>
+constexpr void toroidal_distances2(const BasicVector2D<T> &origin, const T *x, const T *y, int n, T width, T height, T *distance2)
+{
+    for (int k = 0; k < n; k++)
+        distance2[k] = origin.toroidal_offset(BasicVector2D<T>(x[k], y[k]), width, height).length2();
+}
+
+template <typename T>
+T BasicVector2D<T>::get_random_float() {
+    static std::random_device rd;
+    static std::mt19937 engine(rd());
+    static std::uniform_real_distribution<T> dist(0, 1);
+    return dist(engine);
+}
+
+template <typename T>
+constexpr BasicVector2D<T>::BasicVector2D(T x, T y) : x{x}, y{y} {}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator=(T scalar) {
+    x = scalar;
+    y = scalar;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator+(const BasicVector2D &other) const {
+    return BasicVector2D{x + other.x, y + other.y};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator-(const BasicVector2D &other) const {
+    return BasicVector2D{x - other.x, y - other.y};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator+(T scalar) const {
+    return BasicVector2D{x + scalar, y + scalar};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator-(T scalar) const {
+    return BasicVector2D{x - scalar, y - scalar};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator+=(const BasicVector2D &other) {
+    x += other.x;
+    y += other.y;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator-=(const BasicVector2D &other) {
+    x -= other.x;
+    y -= other.y;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator+=(T scalar) {
+    x += scalar;
+    y += scalar;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator-=(T scalar) {
+    x -= scalar;
+    y -= scalar;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator*(const BasicVector2D &other) const {
+    return BasicVector2D{x * other.x, y * other.y};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator*(T scalar) const {
+    return BasicVector2D{x * scalar, y * scalar};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator*=(const BasicVector2D &other) {
+    x *= other.x;
+    y *= other.y;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator*=(T scalar) {
+    x *= scalar;
+    y *= scalar;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator/(const BasicVector2D &other) const {
+    return BasicVector2D{x / other.x, y / other.y};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator/(T scalar) const {
+    return BasicVector2D{x / scalar, y / scalar};
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator/=(const BasicVector2D &other) {
+    if (other.x == 0 || other.y == 0)
+        throw std::invalid_argument("Divide by zero.");
+
+    x /= other.x;
+    y /= other.y;
+    return *this;
+}
+
+template <typename T>
+constexpr BasicVector2D<T> &BasicVector2D<T>::operator/=(T scalar) {
+    if (scalar == 0)
+        throw std::invalid_argument("Divide by zero.");
+
+    x /= scalar;
+    y /= scalar;
+    return *this;
+}
+
+template <typename T>
+constexpr bool BasicVector2D<T>::operator==(const BasicVector2D &other) const {
+    return x == other.x && y == other.y;
+}
+
+template <typename T>
+constexpr bool BasicVector2D<T>::operator!=(const BasicVector2D &other) const {
+    return !(x == other.x && y == other.y);
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::operator-() const {
+    return BasicVector2D{-x, -y};
+}
+
+template <typename T>
+T BasicVector2D<T>::distance(const BasicVector2D &other) const {
+    T dx = x - other.x;
+    T dy = y - other.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+template <typename T>
+constexpr BasicVector2D<T> BasicVector2D<T>::toroidal_offset(const BasicVector2D &other, T width, T height) const {
+    BasicVector2D offset{other.x - x, other.y - y};
+
+    if (offset.x > width / 2)
+        offset.x -= width;
+    if (offset.x <= -width / 2)
+        offset.x += width;
+
+    if (offset.y > height / 2)
+        offset.y -= height;
+    if (offset.y <= -height / 2)
+        offset.y += height;
+
+    return offset;
+}
+
+template <typename T>
+constexpr T BasicVector2D<T>::toroidal_distance2(const BasicVector2D &other, T width, T height) const {
+    T dx = x - other.x;
+    T dy = y - other.y;
+
+    if (dx > width / 2)
+        dx = width - dx;
+    if (dx <= -width / 2)
+        dx = width + dx;
+
+    if (dy > height / 2)
+        dy = height - dy;
+    if (dy <= -height / 2)
+        dy = height + dy;
+
+    return dx * dx + dy * dy;
+}
+
+template <typename T>
+T BasicVector2D<T>::toroidal_distance(const BasicVector2D &other, T width, T height) const {
+    return std::sqrt(toroidal_distance2(other, width, height));
+}
+
+template <typename T>
+T BasicVector2D<T>::norm() const {
+    return std::sqrt(x * x + y * y);
+}
+
+template <typename T>
+BasicVector2D<T> &BasicVector2D<T>::normalize() {
+    T magnitude = norm();
+    if (magnitude != 0) {
+        x /= magnitude;
+        y /= magnitude;
+    }
+    return *this;
+}
+
+template <typename T>
+BasicVector2D<T> &BasicVector2D<T>::limit(T max) {
+    T magnitude = norm();
+    if (magnitude > max) {
+        x *= max / magnitude;
+        y *= max / magnitude;
+    }
+    return *this;
+}
+
+template <typename T>
+BasicVector2D<T> BasicVector2D<T>::random() {
+    return BasicVector2D{get_random_float(), get_random_float()};
+}
+
+template <typename T>
+constexpr T BasicVector2D<T>::length2() const {
+    return x * x + y * y;
+}
 
 #endif //BOIDS_VECTOR2D_H
@@ -0,0 +1,90 @@
+//
+// Created on 2026-10-17.
+//
+
+#ifndef VerletList_H
+#define VerletList_H
+
+#include <vector>
+#include "ParticleStore.h"
+#include "SpeciesTable.h"
+
+// Per-particle candidate lists of everything within perception + skin. The
+// lists stay valid until some particle could have closed the skin, so the
+// spatial index only has to be queried when they are rebuilt.
+class VerletList
+{
+private:
+    Real width = 0, height = 0;
+    Real skin = 0;
+    bool valid = false;
+
+    const ParticleStore *particles = nullptr;
+    std::vector<int> start;
+    std::vector<int> items;
+    std::vector<Vector2D> origin;
+
+public:
+    VerletList();
+
+    void invalidate();
+
+    bool needs_rebuild(const ParticleStore &particles, const SpeciesTable &species, Real skin) const;
+
+    template <typename Index>
+    void build(const ParticleStore &particles, const Index &index, const SpeciesTable &species, Real width, Real height, Real skin);
+
+    template <typename F>
+    void for_each_candidate_range(int query, Real radius, F &&f) const;
+
+    template <typename F>
+    void for_each_neighbor(int query, Real radius, F &&f) const;
+};
+
+template <typename Index>
+void VerletList::build(const ParticleStore &particles, const Index &index, const SpeciesTable &species, Real width, Real height, Real skin)
+{
+    this->width = width;
+    this->height = height;
+    this->skin = skin;
+    this->particles = &particles;
+
+    start.assign(1, 0);
+    items.clear();
+    origin.clear();
+
+    for (int i = 0; i < particles.size(); i++)
+    {
+        index.for_each_neighbor(i, species[particles.species[i]].perception + skin, [&](int other, const Vector2D &) {
+            if (other != i)
+                items.push_back(other);
+        });
+        start.push_back(static_cast<int>(items.size()));
+        origin.push_back(particles.position(i));
+    }
+
+    valid = true;
+}
+
+// The query's whole list is one range.
+template <typename F>
+void VerletList::for_each_candidate_range(int query, Real, F &&f) const
+{
+    f(items.data() + start[query], start[query + 1] - start[query]);
+}
+
+// Same contract as the spatial indices: the candidates are filtered down to
+// the exact neighbours using current positions.
+template <typename F>
+void VerletList::for_each_neighbor(int query, Real radius, F &&f) const
+{
+    Vector2D position = particles->position(query);
+    for (int k = start[query]; k < start[query + 1]; k++)
+    {
+        Vector2D offset = position.toroidal_offset(particles->position(items[k]), width, height);
+        if (offset.length2() < radius * radius)
+            f(items[k], offset);
+    }
+}
+
+#endif
@@ -0,0 +1,31 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <cmath>
+#include "CandidateBatch.h"
+
+CandidateBatch::CandidateBatch(const ParticleStore &particles, Real width, Real height)
+{
+    this->particles = &particles;
+    this->width = width;
+    this->height = height;
+}
+
+// A disk around the queries' bounding box that holds every neighbour within radius of any of them.
+PeriodicQuery CandidateBatch::bounds(Real radius) const
+{
+    Real min_x = width, max_x = 0, min_y = height, max_y = 0;
+    for (int query : queries)
+    {
+        min_x = std::min(min_x, particles->x[query]);
+        max_x = std::max(max_x, particles->x[query]);
+        min_y = std::min(min_y, particles->y[query]);
+        max_y = std::max(max_y, particles->y[query]);
+    }
+
+    Vector2D center{(min_x + max_x) / 2, (min_y + max_y) / 2};
+    Real half_diagonal = std::sqrt((max_x - min_x) * (max_x - min_x) + (max_y - min_y) * (max_y - min_y)) / 2;
+    return PeriodicQuery(center, radius + half_diagonal, width, height);
+}
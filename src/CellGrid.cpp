@@ -0,0 +1,109 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include "CellGrid.h"
+
+CellGrid::CellGrid() = default;
+
+int CellGrid::column(Real x) const
+{
+    return std::clamp(static_cast<int>(x / cell_width), 0, columns - 1);
+}
+
+int CellGrid::row(Real y) const
+{
+    return std::clamp(static_cast<int>(y / cell_height), 0, rows - 1);
+}
+
+void CellGrid::build(const ParticleStore &particles, Real width, Real height, Real cell_size, ThreadPool &pool, int slack)
+{
+    this->particles = &particles;
+    this->width = width;
+    this->height = height;
+
+    // Cells are at least `cell_size` wide, so a query of that radius only has to look one cell around.
+    columns = std::max(1, static_cast<int>(width / cell_size));
+    rows = std::max(1, static_cast<int>(height / cell_size));
+    cell_width = width / columns;
+    cell_height = height / rows;
+
+    int n = particles.size();
+    int n_cells = columns * rows;
+    cell_of.resize(n);
+    items.resize(n + n_cells * slack);
+
+    pool.for_each_chunk(n, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++)
+            cell_of[i] = row(particles.y[i]) * columns + column(particles.x[i]);
+    });
+
+    cells.sort(cell_of, n_cells, pool);
+
+    cell_begin.resize(n_cells + 1);
+    cell_end.resize(n_cells);
+    for (int c = 0; c < n_cells; c++)
+    {
+        cell_begin[c] = cells.start[c] + c * slack;
+        cell_end[c] = cells.start[c + 1] + c * slack;
+    }
+    cell_begin[n_cells] = n + n_cells * slack;
+
+    // Sorted position k of a particle in cell c lands c * slack slots further on.
+    updatable = slack > 0;
+    slot_of.resize(slack > 0 ? n : 0);
+    pool.for_each_chunk(n, [&](int, int begin, int end) {
+        for (int k = begin; k < end; k++)
+        {
+            int i = cells.order[k];
+            int slot = k + cell_of[i] * slack;
+            items[slot] = i;
+            if (slack > 0)
+                slot_of[i] = slot;
+        }
+    });
+}
+
+// Moves the particles that left their cell since the last build or update. Returns false,
+// leaving the grid to be built again, if it was built without slack, if particles were
+// added or if a cell ran out of free slots. Callers rebuild after reordering the store.
+bool CellGrid::update(ThreadPool &pool)
+{
+    if (!updatable || particles->size() != static_cast<int>(cell_of.size()))
+        return false;
+
+    const ParticleStore &particles = *this->particles;
+    int n = particles.size();
+    crossed.resize(pool.size());
+    pool.for_each_chunk(n, [&](int chunk, int begin, int end) {
+        crossed[chunk].clear();
+        for (int i = begin; i < end; i++)
+            if (row(particles.y[i]) * columns + column(particles.x[i]) != cell_of[i])
+                crossed[chunk].push_back(i);
+    });
+
+    for (const std::vector<int> &chunk : crossed)
+    {
+        for (int i : chunk)
+        {
+            int from = cell_of[i];
+            int to = row(particles.y[i]) * columns + column(particles.x[i]);
+            if (cell_end[to] == cell_begin[to + 1])
+            {
+                updatable = false;
+                return false;
+            }
+
+            // The last particle of the old cell fills the hole.
+            int last = --cell_end[from];
+            items[slot_of[i]] = items[last];
+            slot_of[items[last]] = slot_of[i];
+
+            items[cell_end[to]] = i;
+            slot_of[i] = cell_end[to]++;
+            cell_of[i] = to;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,84 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <numeric>
+#include "CountingSort.h"
+
+CountingSort::CountingSort() = default;
+
+void CountingSort::sort(const std::vector<int> &keys, int n_keys, ThreadPool &pool)
+{
+    int n = static_cast<int>(keys.size());
+    start.resize(n_keys + 1);
+    order.resize(n);
+    fill.resize(n_keys);
+
+    int n_bands = pool.size();
+    if (n_bands == 1)
+    {
+        banded.resize(n);
+        std::iota(banded.begin(), banded.end(), 0);
+        sort_range(keys, banded.data(), n, 0, n_keys, 0);
+        start[n_keys] = n;
+        return;
+    }
+
+    auto band_of = [n_keys, n_bands](int key) {
+        return static_cast<int>(static_cast<long long>(key) * n_bands / n_keys);
+    };
+
+    // Histogram of bands per chunk, laid out band major so a single prefix sum gives every chunk its slots.
+    band_counts.assign(n_bands * n_bands, 0);
+    pool.for_each_chunk(n, [&](int chunk, int begin, int end) {
+        for (int i = begin; i < end; i++)
+            band_counts[band_of(keys[i]) * n_bands + chunk]++;
+    });
+
+    band_start.assign(n_bands + 1, 0);
+    int total = 0;
+    for (int band = 0; band < n_bands; band++)
+    {
+        band_start[band] = total;
+        for (int chunk = 0; chunk < n_bands; chunk++)
+        {
+            int count = band_counts[band * n_bands + chunk];
+            band_counts[band * n_bands + chunk] = total;
+            total += count;
+        }
+    }
+    band_start[n_bands] = total;
+
+    banded.resize(n);
+    pool.for_each_chunk(n, [&](int chunk, int begin, int end) {
+        for (int i = begin; i < end; i++)
+            banded[band_counts[band_of(keys[i]) * n_bands + chunk]++] = i;
+    });
+
+    // Bands own disjoint ranges of keys and of order, so they sort independently.
+    pool.run(n_bands, [&](int band) {
+        int first_key = static_cast<int>((static_cast<long long>(n_keys) * band + n_bands - 1) / n_bands);
+        int last_key = static_cast<int>((static_cast<long long>(n_keys) * (band + 1) + n_bands - 1) / n_bands);
+        sort_range(keys, banded.data() + band_start[band], band_start[band + 1] - band_start[band], first_key, last_key, band_start[band]);
+    });
+    start[n_keys] = n;
+}
+
+// Sorts n indices whose keys lie in [first_key, last_key) into order, starting at offset.
+void CountingSort::sort_range(const std::vector<int> &keys, const int *indices, int n, int first_key, int last_key, int offset)
+{
+    std::fill(fill.begin() + first_key, fill.begin() + last_key, 0);
+    for (int i = 0; i < n; i++)
+        fill[keys[indices[i]]]++;
+
+    for (int key = first_key; key < last_key; key++)
+    {
+        start[key] = offset;
+        offset += fill[key];
+        fill[key] = start[key];
+    }
+
+    for (int i = 0; i < n; i++)
+        order[fill[keys[indices[i]]]++] = indices[i];
+}
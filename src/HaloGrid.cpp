@@ -0,0 +1,93 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <stdexcept>
+#include "HaloGrid.h"
+
+HaloGrid::HaloGrid() = default;
+
+int HaloGrid::column(Real x) const
+{
+    return std::clamp(static_cast<int>(x / cell_width), 0, columns - 1);
+}
+
+int HaloGrid::row(Real y) const
+{
+    return std::clamp(static_cast<int>(y / cell_height), 0, rows - 1);
+}
+
+void HaloGrid::build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool)
+{
+    this->particles = &particles;
+    halo = *std::max_element(radii.begin(), radii.end());
+
+    // A wider layer would let a query reach two copies of the same particle.
+    if (2 * halo > width || 2 * halo > height)
+        throw std::invalid_argument("Ghost halo is wider than half the simulation area.");
+
+    Real padded_width = width + 2 * halo, padded_height = height + 2 * halo;
+    columns = std::max(1, static_cast<int>(padded_width / halo));
+    rows = std::max(1, static_cast<int>(padded_height / halo));
+    cell_width = padded_width / columns;
+    cell_height = padded_height / rows;
+
+    // Every particle plus a copy for each border (and corner) it is within the halo of.
+    auto for_each_copy = [&](int i, auto &&emit) {
+        Real x = particles.x[i] + halo, y = particles.y[i] + halo;
+        Real shifts_x[2] = {0, 0}, shifts_y[2] = {0, 0};
+        int n_x = 1, n_y = 1;
+        if (particles.x[i] < halo)
+            shifts_x[n_x++] = width;
+        else if (particles.x[i] >= width - halo)
+            shifts_x[n_x++] = -width;
+        if (particles.y[i] < halo)
+            shifts_y[n_y++] = height;
+        else if (particles.y[i] >= height - halo)
+            shifts_y[n_y++] = -height;
+
+        for (int a = 0; a < n_x; a++)
+            for (int b = 0; b < n_y; b++)
+                emit(Vector2D{x + shifts_x[a], y + shifts_y[b]});
+    };
+
+    // Count the copies per chunk first so every chunk knows where to write its own.
+    int n = particles.size();
+    chunk_start.assign(pool.size() + 1, 0);
+    pool.for_each_chunk(n, [&](int chunk, int begin, int end) {
+        for (int i = begin; i < end; i++)
+            for_each_copy(i, [&](const Vector2D &) { chunk_start[chunk + 1]++; });
+    });
+    for (int chunk = 0; chunk < pool.size(); chunk++)
+        chunk_start[chunk + 1] += chunk_start[chunk];
+
+    int n_points = chunk_start[pool.size()];
+    ghost_points.resize(n_points);
+    ghost_sources.resize(n_points);
+    cell_of.resize(n_points);
+    pool.for_each_chunk(n, [&](int chunk, int begin, int end) {
+        int k = chunk_start[chunk];
+        for (int i = begin; i < end; i++)
+        {
+            for_each_copy(i, [&](const Vector2D &point) {
+                ghost_points[k] = point;
+                ghost_sources[k] = i;
+                cell_of[k] = row(point.y) * columns + column(point.x);
+                k++;
+            });
+        }
+    });
+
+    cells.sort(cell_of, columns * rows, pool);
+
+    points.resize(n_points);
+    sources.resize(n_points);
+    pool.for_each_chunk(n_points, [&](int, int begin, int end) {
+        for (int k = begin; k < end; k++)
+        {
+            points[k] = ghost_points[cells.order[k]];
+            sources[k] = ghost_sources[cells.order[k]];
+        }
+    });
+}
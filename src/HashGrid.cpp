@@ -0,0 +1,86 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <atomic>
+#include "HashGrid.h"
+
+HashGrid::HashGrid() = default;
+
+std::int64_t HashGrid::column(Real x) const
+{
+    return std::clamp(static_cast<std::int64_t>(x / cell_width), std::int64_t(0), columns - 1);
+}
+
+std::int64_t HashGrid::row(Real y) const
+{
+    return std::clamp(static_cast<std::int64_t>(y / cell_height), std::int64_t(0), rows - 1);
+}
+
+// First slot probed for a key, from a multiplicative hash.
+std::uint64_t HashGrid::home(std::uint64_t key) const
+{
+    return ((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+// Linear probing from the home slot. Returns nullptr for an empty cell.
+const HashGrid::Cell *HashGrid::find(std::uint64_t key) const
+{
+    for (std::uint64_t slot = home(key);; slot = (slot + 1) & mask)
+    {
+        if (table[slot].key == key)
+            return &table[slot];
+        if (table[slot].key == empty)
+            return nullptr;
+    }
+}
+
+void HashGrid::build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool)
+{
+    this->particles = &particles;
+    this->width = width;
+    this->height = height;
+
+    Real cell_size = radii.empty() ? 1 : *std::max_element(radii.begin(), radii.end());
+    columns = std::max(std::int64_t(1), static_cast<std::int64_t>(width / cell_size));
+    rows = std::max(std::int64_t(1), static_cast<std::int64_t>(height / cell_size));
+    cell_width = width / columns;
+    cell_height = height / rows;
+
+    int n = particles.size();
+
+    // Room for every particle in a cell of its own at most half full, so probe sequences stay short.
+    std::uint64_t size = 16;
+    while (size < 2 * static_cast<std::uint64_t>(n))
+        size *= 2;
+    mask = size - 1;
+    table.assign(size, Cell{empty, 0, 0});
+
+    // Threads claim the slots of new cells with a compare-and-swap, and every particle remembers its cell's slot.
+    slot_of.resize(n);
+    pool.for_each_chunk(n, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            std::uint64_t key = static_cast<std::uint64_t>(row(particles.y[i]) * columns + column(particles.x[i]));
+            std::uint64_t slot = home(key);
+            for (;; slot = (slot + 1) & mask)
+            {
+                std::uint64_t found = empty;
+                if (std::atomic_ref<std::uint64_t>(table[slot].key).compare_exchange_strong(found, key) || found == key)
+                    break;
+            }
+            slot_of[i] = static_cast<int>(slot);
+        }
+    });
+
+    // Sorting by slot makes every occupied cell a contiguous range of the order.
+    cells.sort(slot_of, static_cast<int>(size), pool);
+    pool.for_each_chunk(static_cast<int>(size), [&](int, int begin, int end) {
+        for (int slot = begin; slot < end; slot++)
+        {
+            table[slot].begin = cells.start[slot];
+            table[slot].end = cells.start[slot + 1];
+        }
+    });
+}
@@ -0,0 +1,44 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <cmath>
+#include "HeadingTable.h"
+
+std::uint32_t heading_from_turns(double turns)
+{
+    // Going through 64 bits keeps whole turns, positive or negative, wrapping cleanly.
+    return static_cast<std::uint32_t>(std::llround(turns * 4294967296.0));
+}
+
+Real turns_from_heading(std::uint32_t heading)
+{
+    return static_cast<Real>(heading / 4294967296.0);
+}
+
+HeadingTable::HeadingTable(int bits)
+{
+    this->bits = bits > 0 ? std::clamp(bits, 2, 24) : 0;
+
+    cosines.resize(this->bits > 0 ? std::size_t(1) << this->bits : 0);
+    for (std::size_t k = 0; k < cosines.size(); k++)
+        cosines[k] = static_cast<Real>(cos(2 * M_PI * k / cosines.size()));
+}
+
+void HeadingTable::direction(std::uint32_t heading, Real &c, Real &s) const
+{
+    if (bits == 0)
+    {
+        double angle = heading / 4294967296.0 * 2 * M_PI;
+        c = static_cast<Real>(cos(angle));
+        s = static_cast<Real>(sin(angle));
+        return;
+    }
+
+    // Round to the nearest entry; the sine is the cosine a quarter turn earlier.
+    std::uint32_t mask = (std::uint32_t(1) << bits) - 1;
+    std::uint32_t k = ((heading >> (31 - bits)) + 1) >> 1;
+    c = cosines[k & mask];
+    s = cosines[(k - (std::uint32_t(1) << (bits - 2))) & mask];
+}
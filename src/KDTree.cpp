@@ -3,155 +3,93 @@
 // Modified by V. Prins 2021-07-16
 //
 
-#include <cmath>
-#include <memory>
+#include <algorithm>
+#include <numeric>
 #include "KDTree.h"
 
-Node::Node(Particle *particle, bool vertical, const Node::NodePtr &left, const Node::NodePtr &right)
-{
-    this->particle = particle;
-    this->vertical = vertical;
-    this->left = left;
-    this->right = right;
-}
-
-Node::~Node() = default;
+KDTree::KDTree() = default;
 
-bool Node::isLeaf() const
+// The tree adapts to any query radius, so it does not need the species radii. The levels
+// above a few subtrees per thread are split one level at a time, the ranges of a level side
+// by side, and the subtrees below are then built in parallel.
+void KDTree::build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &, ThreadPool &pool)
 {
-    return this->left == nullptr && this->right == nullptr;
-}
+    prepare(particles, width, height);
 
-KDTree::KDTree(float width, float height)
-{
-    this->root = nullptr;
-    this->width = width;
-    this->height = height;
-}
+    int parallel_level = 0;
+    while (pool.size() > 1 && (1 << parallel_level) < 4 * pool.size() && parallel_level < depth)
+        parallel_level++;
 
-Node::NodePtr KDTree::insert(const Node::NodePtr &node, Particle *particle, bool vertical)
-{
-    if (node == nullptr)
+    subtrees.assign(1, Subtree{0, 0, static_cast<int>(order.size()), 0});
+    for (int level = 0; level < parallel_level; level++)
     {
-        return std::make_shared<Node>(particle, vertical, nullptr, nullptr);
-    }
+        pool.run(static_cast<int>(subtrees.size()), [this](int i) {
+            split(subtrees[i].node, subtrees[i].begin, subtrees[i].end);
+        });
 
-    if ((node->vertical && particle->position.x < node->particle->position.x) ||
-        (!node->vertical && particle->position.y < node->particle->position.y))
-    {
-        node->left = insert(node->left, particle, !node->vertical);
-    }
-    else
-    {
-        node->right = insert(node->right, particle, !node->vertical);
+        // Children replace their parent from the back, so nothing is overwritten before it is read.
+        subtrees.resize(2 * subtrees.size());
+        for (int i = static_cast<int>(subtrees.size()) / 2 - 1; i >= 0; i--)
+        {
+            Subtree parent = subtrees[i];
+            int mid = parent.begin + (parent.end - parent.begin) / 2;
+            subtrees[2 * i] = Subtree{2 * parent.node + 1, parent.begin, mid, level + 1};
+            subtrees[2 * i + 1] = Subtree{2 * parent.node + 2, mid, parent.end, level + 1};
+        }
     }
 
-    return node;
+    pool.run(static_cast<int>(subtrees.size()), [this](int i) {
+        build(subtrees[i].node, subtrees[i].begin, subtrees[i].end, subtrees[i].level);
+    });
 }
 
-void KDTree::insert(Particle *particle)
+void KDTree::prepare(const ParticleStore &particles, Real width, Real height)
 {
-    root = insert(root, particle, true);
-}
+    this->width = width;
+    this->height = height;
+    this->particles = &particles;
 
-double distance2(const Particle *particle, const Node::NodePtr &node)
-{
-    return std::pow((particle->position.x - node->particle->position.x), 2) +
-           std::pow((particle->position.y - node->particle->position.y), 2);
+    int n = particles.size();
+    depth = 0;
+    while ((n >> depth) > bucket_size)
+        depth++;
+
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+    nodes.resize((1 << depth) - 1);
 }
 
-void KDTree::search(Particle *query, double radius, const Node::NodePtr &node, std::vector<Particle *> &results) const
+// Splits the subtree rooted at node all the way down to its leaves.
+void KDTree::build(int node, int begin, int end, int level)
 {
-    double w = query->position.toroidal_distance2(node->particle->position, this->width, this->height);
-
-    if (node->isLeaf())
-    {
-        if (w < radius * radius)
-        {
-            results.push_back(node->particle);
-        }
+    if (level == depth)
         return;
-    }
-
-    if (w < radius * radius)
-        results.push_back(node->particle);
 
-    double qx = query->position.x;
-    double nx = node->particle->position.x;
-    double qy = query->position.y;
-    double ny = node->particle->position.y;
+    split(node, begin, end);
 
-    if (node->vertical)
-    {
-        if (qx < nx)
-        {
-            if (qx - radius <= nx && node->left != nullptr)
-            {
-                search(query, radius, node->left, results);
-            }
-            if (qx + radius > nx && node->right != nullptr)
-            {
-                search(query, radius, node->right, results);
-                return;
-            }
-        }
-        else
-        {
-            if (qx + radius > nx && node->right != nullptr)
-            {
-                search(query, radius, node->right, results);
-            }
-            if (qx - radius <= nx && node->left != nullptr)
-            {
-                search(query, radius, node->left, results);
-                return;
-            }
-        }
-    }
-    else
-    {
-        if (qy < ny)
-        {
-            if (qy - radius <= ny && node->left != nullptr)
-            {
-                search(query, radius, node->left, results);
-            }
-            if (qy + radius > ny && node->right != nullptr)
-            {
-                search(query, radius, node->right, results);
-                return;
-            }
-        }
-        else
-        {
-            if (qy + radius > ny && node->right != nullptr)
-            {
-                search(query, radius, node->right, results);
-            }
-            if (qy - radius <= ny && node->left != nullptr)
-            {
-                search(query, radius, node->left, results);
-                return;
-            }
-        }
-    }
+    int mid = begin + (end - begin) / 2;
+    build(2 * node + 1, begin, mid, level + 1);
+    build(2 * node + 2, mid, end, level + 1);
 }
 
-std::vector<Particle*> KDTree::search(Particle *query, double radius) const
+// Partitions the range of node at its median along the axis with the largest spread.
+void KDTree::split(int node, int begin, int end)
 {
-    std::vector<Particle*> results;
-
-    bool subtract_width = query->position.x > width/2;
-    bool subtract_height = query->position.y > height/2;
+    // Clustered ranges stay balanced whichever axis they are split along.
+    Real min_x = width, max_x = 0, min_y = height, max_y = 0;
+    for (int i = begin; i < end; i++)
+    {
+        min_x = std::min(min_x, particles->x[order[i]]);
+        max_x = std::max(max_x, particles->x[order[i]]);
+        min_y = std::min(min_y, particles->y[order[i]]);
+        max_y = std::max(max_y, particles->y[order[i]]);
+    }
+    bool vertical = max_x - min_x >= max_y - min_y;
 
-    auto p = *query;
-    search(&p, radius, root, results);
-    p.position.x += (subtract_width) ? -width : width;
-    search(&p, radius, root, results);
-    p.position.y += (subtract_height) ? -height : height;
-    search(&p, radius, root, results);
-    p.position.x -= (subtract_width) ? -width : width;
-    search(&p, radius, root, results);
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [this, vertical](int a, int b) {
+        return vertical ? particles->x[a] < particles->x[b] : particles->y[a] < particles->y[b];
+    });
 
-    return results;
+    nodes[node] = Node{vertical ? particles->x[order[mid]] : particles->y[order[mid]], vertical};
 }
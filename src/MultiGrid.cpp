@@ -0,0 +1,54 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <numeric>
+#include "MultiGrid.h"
+
+MultiGrid::MultiGrid(bool incremental) : incremental(incremental)
+{
+}
+
+// radii[s] is the largest radius species s will query with.
+void MultiGrid::build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &radii, ThreadPool &pool)
+{
+    this->radii = radii;
+    this->particles = &particles;
+
+    std::vector<int> by_radius(radii.size());
+    std::iota(by_radius.begin(), by_radius.end(), 0);
+    std::sort(by_radius.begin(), by_radius.end(), [&radii](int a, int b) { return radii[a] < radii[b]; });
+
+    // Greedily group species, starting a new level once a radius outgrows the smallest one of the current level.
+    std::vector<Real> cell_sizes;
+    species_level.resize(radii.size());
+    Real smallest = 0;
+    for (int s : by_radius)
+    {
+        if (cell_sizes.empty() || radii[s] > smallest * level_ratio)
+        {
+            smallest = radii[s];
+            cell_sizes.push_back(radii[s]);
+        }
+        cell_sizes.back() = radii[s];
+        species_level[s] = static_cast<int>(cell_sizes.size()) - 1;
+    }
+
+    levels.resize(cell_sizes.size());
+    for (size_t level = 0; level < levels.size(); level++)
+        levels[level].build(particles, width, height, cell_sizes[level], pool, incremental ? incremental_slack : 0);
+}
+
+// Brings the levels up to date without rebuilding them, see CellGrid::update. Returns false
+// if the grid has to be built again, also when the radii have changed since the last build.
+bool MultiGrid::update(const std::vector<Real> &radii, ThreadPool &pool)
+{
+    if (!incremental || radii != this->radii)
+        return false;
+
+    for (CellGrid &level : levels)
+        if (!level.update(pool))
+            return false;
+    return true;
+}
@@ -0,0 +1,248 @@
+//
+// Created on 2026-10-17.
+//
+
+#include "NeighborKernel.h"
+
+// The vector kernels work on float lanes; the double reference build only has the scalar ones.
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(URSOUP_DOUBLE)
+#include <immintrin.h>
+#define NEIGHBOR_KERNEL_X86
+#endif
+
+static void classify_scalar(const NeighborQuery &query, const Real *x, const Real *y, const int *candidates, int n, Neighborhood &neighborhood)
+{
+    const Real half_width = query.width / 2, half_height = query.height / 2;
+    const Real close2 = Real(1.3 * 1.3);
+
+    for (int k = 0; k < n; k++)
+    {
+        int j = candidates[k];
+        Real dx = x[j] - query.x, dy = y[j] - query.y;
+        if (dx > half_width)
+            dx -= query.width;
+        if (dx <= -half_width)
+            dx += query.width;
+        if (dy > half_height)
+            dy -= query.height;
+        if (dy <= -half_height)
+            dy += query.height;
+
+        Real distance2 = dx * dx + dy * dy;
+        if (distance2 >= query.radius2 || j == query.self)
+            continue;
+
+        if (distance2 < close2)
+            neighborhood.close++;
+        (query.c * dy - query.s * dx > 0) ? neighborhood.left++ : neighborhood.right++;
+    }
+}
+
+static void classify_quantized_scalar(const NeighborQuery &query, const std::uint32_t *packed, const int *candidates, int n, Neighborhood &neighborhood)
+{
+    const Real close2 = Real(1.3 * 1.3);
+
+    for (int k = 0; k < n; k++)
+    {
+        int j = candidates[k];
+        Real dx = static_cast<std::int16_t>(static_cast<std::uint16_t>(packed[j] - query.packed)) * query.unit_x;
+        Real dy = static_cast<std::int16_t>(static_cast<std::uint16_t>((packed[j] >> 16) - (query.packed >> 16))) * query.unit_y;
+
+        Real distance2 = dx * dx + dy * dy;
+        if (distance2 >= query.radius2 || j == query.self)
+            continue;
+
+        if (distance2 < close2)
+            neighborhood.close++;
+        (query.c * dy - query.s * dx > 0) ? neighborhood.left++ : neighborhood.right++;
+    }
+}
+
+#ifdef NEIGHBOR_KERNEL_X86
+
+// Eight candidates per step. The wrap is applied through compare masks, and the masks of the
+// neighbours, close ones and left ones are counted with popcounts. The tail is loaded and
+// gathered under a lane mask.
+__attribute__((target("avx2,popcnt")))
+static void classify_avx2(const NeighborQuery &query, const float *x, const float *y, const int *candidates, int n, Neighborhood &neighborhood)
+{
+    const __m256 qx = _mm256_set1_ps(query.x), qy = _mm256_set1_ps(query.y);
+    const __m256 width = _mm256_set1_ps(query.width), height = _mm256_set1_ps(query.height);
+    const __m256 half_width = _mm256_set1_ps(query.width / 2), half_height = _mm256_set1_ps(query.height / 2);
+    const __m256 minus_half_width = _mm256_set1_ps(-query.width / 2), minus_half_height = _mm256_set1_ps(-query.height / 2);
+    const __m256 radius2 = _mm256_set1_ps(query.radius2), close2 = _mm256_set1_ps(1.3f * 1.3f);
+    const __m256 c = _mm256_set1_ps(query.c), s = _mm256_set1_ps(query.s);
+    const __m256i self = _mm256_set1_epi32(query.self);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (int k = 0; k < n; k += 8)
+    {
+        __m256i lanes = _mm256_cmpgt_epi32(_mm256_set1_epi32(n - k), lane);
+        __m256i indices = _mm256_maskload_epi32(candidates + k, lanes);
+        __m256 dx = _mm256_sub_ps(_mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, indices, _mm256_castsi256_ps(lanes), 4), qx);
+        __m256 dy = _mm256_sub_ps(_mm256_mask_i32gather_ps(_mm256_setzero_ps(), y, indices, _mm256_castsi256_ps(lanes), 4), qy);
+
+        dx = _mm256_sub_ps(dx, _mm256_and_ps(_mm256_cmp_ps(dx, half_width, _CMP_GT_OQ), width));
+        dx = _mm256_add_ps(dx, _mm256_and_ps(_mm256_cmp_ps(dx, minus_half_width, _CMP_LE_OQ), width));
+        dy = _mm256_sub_ps(dy, _mm256_and_ps(_mm256_cmp_ps(dy, half_height, _CMP_GT_OQ), height));
+        dy = _mm256_add_ps(dy, _mm256_and_ps(_mm256_cmp_ps(dy, minus_half_height, _CMP_LE_OQ), height));
+
+        __m256 distance2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 is_self = _mm256_castsi256_ps(_mm256_cmpeq_epi32(indices, self));
+        __m256 inside = _mm256_and_ps(_mm256_castsi256_ps(lanes), _mm256_andnot_ps(is_self, _mm256_cmp_ps(distance2, radius2, _CMP_LT_OQ)));
+        __m256 close = _mm256_and_ps(inside, _mm256_cmp_ps(distance2, close2, _CMP_LT_OQ));
+        __m256 side = _mm256_sub_ps(_mm256_mul_ps(c, dy), _mm256_mul_ps(s, dx));
+        __m256 left = _mm256_and_ps(inside, _mm256_cmp_ps(side, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+        int n_inside = _mm_popcnt_u32(_mm256_movemask_ps(inside));
+        int n_left = _mm_popcnt_u32(_mm256_movemask_ps(left));
+        neighborhood.close += _mm_popcnt_u32(_mm256_movemask_ps(close));
+        neighborhood.left += n_left;
+        neighborhood.right += n_inside - n_left;
+    }
+}
+
+// Sixteen candidates per step, with the tail handled by a masked load and gather.
+__attribute__((target("avx512f,popcnt")))
+static void classify_avx512(const NeighborQuery &query, const float *x, const float *y, const int *candidates, int n, Neighborhood &neighborhood)
+{
+    const __m512 qx = _mm512_set1_ps(query.x), qy = _mm512_set1_ps(query.y);
+    const __m512 width = _mm512_set1_ps(query.width), height = _mm512_set1_ps(query.height);
+    const __m512 half_width = _mm512_set1_ps(query.width / 2), half_height = _mm512_set1_ps(query.height / 2);
+    const __m512 minus_half_width = _mm512_set1_ps(-query.width / 2), minus_half_height = _mm512_set1_ps(-query.height / 2);
+    const __m512 radius2 = _mm512_set1_ps(query.radius2), close2 = _mm512_set1_ps(1.3f * 1.3f);
+    const __m512 c = _mm512_set1_ps(query.c), s = _mm512_set1_ps(query.s);
+    const __m512i self = _mm512_set1_epi32(query.self);
+
+    for (int k = 0; k < n; k += 16)
+    {
+        __mmask16 lanes = n - k >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << (n - k)) - 1);
+        __m512i indices = _mm512_maskz_loadu_epi32(lanes, candidates + k);
+        __m512 dx = _mm512_sub_ps(_mm512_mask_i32gather_ps(_mm512_setzero_ps(), lanes, indices, x, 4), qx);
+        __m512 dy = _mm512_sub_ps(_mm512_mask_i32gather_ps(_mm512_setzero_ps(), lanes, indices, y, 4), qy);
+
+        dx = _mm512_mask_sub_ps(dx, _mm512_cmp_ps_mask(dx, half_width, _CMP_GT_OQ), dx, width);
+        dx = _mm512_mask_add_ps(dx, _mm512_cmp_ps_mask(dx, minus_half_width, _CMP_LE_OQ), dx, width);
+        dy = _mm512_mask_sub_ps(dy, _mm512_cmp_ps_mask(dy, half_height, _CMP_GT_OQ), dy, height);
+        dy = _mm512_mask_add_ps(dy, _mm512_cmp_ps_mask(dy, minus_half_height, _CMP_LE_OQ), dy, height);
+
+        __m512 distance2 = _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy));
+        __mmask16 inside = _mm512_mask_cmp_ps_mask(lanes & ~_mm512_cmpeq_epi32_mask(indices, self), distance2, radius2, _CMP_LT_OQ);
+        __mmask16 close = _mm512_mask_cmp_ps_mask(inside, distance2, close2, _CMP_LT_OQ);
+        __m512 side = _mm512_sub_ps(_mm512_mul_ps(c, dy), _mm512_mul_ps(s, dx));
+        __mmask16 left = _mm512_mask_cmp_ps_mask(inside, side, _mm512_setzero_ps(), _CMP_GT_OQ);
+
+        int n_inside = _mm_popcnt_u32(inside);
+        int n_left = _mm_popcnt_u32(left);
+        neighborhood.close += _mm_popcnt_u32(close);
+        neighborhood.left += n_left;
+        neighborhood.right += n_inside - n_left;
+    }
+}
+
+// One gather fetches both packed coordinates. Shifting the halves to the top of each lane makes
+// the 32-bit subtraction wrap like a 16-bit one, and an arithmetic shift brings the delta back.
+__attribute__((target("avx2,popcnt")))
+static void classify_quantized_avx2(const NeighborQuery &query, const std::uint32_t *packed, const int *candidates, int n, Neighborhood &neighborhood)
+{
+    const __m256i qx = _mm256_set1_epi32(static_cast<int>(query.packed << 16)), qy = _mm256_set1_epi32(static_cast<int>(query.packed & 0xFFFF0000u));
+    const __m256i high = _mm256_set1_epi32(static_cast<int>(0xFFFF0000u));
+    const __m256 unit_x = _mm256_set1_ps(query.unit_x), unit_y = _mm256_set1_ps(query.unit_y);
+    const __m256 radius2 = _mm256_set1_ps(query.radius2), close2 = _mm256_set1_ps(1.3f * 1.3f);
+    const __m256 c = _mm256_set1_ps(query.c), s = _mm256_set1_ps(query.s);
+    const __m256i self = _mm256_set1_epi32(query.self);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (int k = 0; k < n; k += 8)
+    {
+        __m256i lanes = _mm256_cmpgt_epi32(_mm256_set1_epi32(n - k), lane);
+        __m256i indices = _mm256_maskload_epi32(candidates + k, lanes);
+        __m256i positions = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int *>(packed), indices, lanes, 4);
+
+        __m256i delta_x = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_slli_epi32(positions, 16), qx), 16);
+        __m256i delta_y = _mm256_srai_epi32(_mm256_sub_epi32(_mm256_and_si256(positions, high), qy), 16);
+        __m256 dx = _mm256_mul_ps(_mm256_cvtepi32_ps(delta_x), unit_x);
+        __m256 dy = _mm256_mul_ps(_mm256_cvtepi32_ps(delta_y), unit_y);
+
+        __m256 distance2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 is_self = _mm256_castsi256_ps(_mm256_cmpeq_epi32(indices, self));
+        __m256 inside = _mm256_and_ps(_mm256_castsi256_ps(lanes), _mm256_andnot_ps(is_self, _mm256_cmp_ps(distance2, radius2, _CMP_LT_OQ)));
+        __m256 close = _mm256_and_ps(inside, _mm256_cmp_ps(distance2, close2, _CMP_LT_OQ));
+        __m256 side = _mm256_sub_ps(_mm256_mul_ps(c, dy), _mm256_mul_ps(s, dx));
+        __m256 left = _mm256_and_ps(inside, _mm256_cmp_ps(side, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+        int n_inside = _mm_popcnt_u32(_mm256_movemask_ps(inside));
+        int n_left = _mm_popcnt_u32(_mm256_movemask_ps(left));
+        neighborhood.close += _mm_popcnt_u32(_mm256_movemask_ps(close));
+        neighborhood.left += n_left;
+        neighborhood.right += n_inside - n_left;
+    }
+}
+
+__attribute__((target("avx512f,popcnt")))
+static void classify_quantized_avx512(const NeighborQuery &query, const std::uint32_t *packed, const int *candidates, int n, Neighborhood &neighborhood)
+{
+    const __m512i qx = _mm512_set1_epi32(static_cast<int>(query.packed << 16)), qy = _mm512_set1_epi32(static_cast<int>(query.packed & 0xFFFF0000u));
+    const __m512i high = _mm512_set1_epi32(static_cast<int>(0xFFFF0000u));
+    const __m512 unit_x = _mm512_set1_ps(query.unit_x), unit_y = _mm512_set1_ps(query.unit_y);
+    const __m512 radius2 = _mm512_set1_ps(query.radius2), close2 = _mm512_set1_ps(1.3f * 1.3f);
+    const __m512 c = _mm512_set1_ps(query.c), s = _mm512_set1_ps(query.s);
+    const __m512i self = _mm512_set1_epi32(query.self);
+
+    for (int k = 0; k < n; k += 16)
+    {
+        __mmask16 lanes = n - k >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << (n - k)) - 1);
+        __m512i indices = _mm512_maskz_loadu_epi32(lanes, candidates + k);
+        __m512i positions = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), lanes, indices, packed, 4);
+
+        // The zero-masking forms only keep the lanes in use.
+        __m512i delta_x = _mm512_maskz_srai_epi32(lanes, _mm512_sub_epi32(_mm512_maskz_slli_epi32(lanes, positions, 16), qx), 16);
+        __m512i delta_y = _mm512_maskz_srai_epi32(lanes, _mm512_sub_epi32(_mm512_and_si512(positions, high), qy), 16);
+        __m512 dx = _mm512_mul_ps(_mm512_maskz_cvtepi32_ps(lanes, delta_x), unit_x);
+        __m512 dy = _mm512_mul_ps(_mm512_maskz_cvtepi32_ps(lanes, delta_y), unit_y);
+
+        __m512 distance2 = _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy));
+        __mmask16 inside = _mm512_mask_cmp_ps_mask(lanes & ~_mm512_cmpeq_epi32_mask(indices, self), distance2, radius2, _CMP_LT_OQ);
+        __mmask16 close = _mm512_mask_cmp_ps_mask(inside, distance2, close2, _CMP_LT_OQ);
+        __m512 side = _mm512_sub_ps(_mm512_mul_ps(c, dy), _mm512_mul_ps(s, dx));
+        __mmask16 left = _mm512_mask_cmp_ps_mask(inside, side, _mm512_setzero_ps(), _CMP_GT_OQ);
+
+        int n_inside = _mm_popcnt_u32(inside);
+        int n_left = _mm_popcnt_u32(left);
+        neighborhood.close += _mm_popcnt_u32(close);
+        neighborhood.left += n_left;
+        neighborhood.right += n_inside - n_left;
+    }
+}
+
+#endif
+
+KernelIsa best_isa()
+{
+#ifdef NEIGHBOR_KERNEL_X86
+    if (__builtin_cpu_supports("avx512f"))
+        return KernelIsa::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return KernelIsa::avx2;
+#endif
+    return KernelIsa::scalar;
+}
+
+NeighborKernel neighbor_kernel(KernelIsa isa)
+{
+    KernelIsa best = best_isa();
+    if (isa == KernelIsa::automatic || static_cast<int>(isa) > static_cast<int>(best))
+        isa = best;
+
+    switch (isa)
+    {
+#ifdef NEIGHBOR_KERNEL_X86
+    case KernelIsa::avx512:
+        return NeighborKernel{classify_avx512, classify_quantized_avx512};
+    case KernelIsa::avx2:
+        return NeighborKernel{classify_avx2, classify_quantized_avx2};
+#endif
+    default:
+        return NeighborKernel{classify_scalar, classify_quantized_scalar};
+    }
+}
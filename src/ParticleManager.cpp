@@ -3,15 +3,17 @@
 // Modified by V. Prins 2021-07-16
 //
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <cstdint>
 #include "ParticleManager.h"
-#include "KDTree.h"
 
 ParticleManager::ParticleManager() = default;
 
 ParticleManager::ParticleManager(const ParticleManager &other)
 {
-    for (const Particle &particle : other.particles)
-        particles.emplace_back(particle);
+    particles = other.particles;
 }
 
 ParticleManager::~ParticleManager() = default;
@@ -21,23 +23,276 @@ Particle ParticleManager::operator[](int i) const
     return particles[i];
 }
 
+const ParticleStore &ParticleManager::store() const
+{
+    return particles;
+}
+
 void ParticleManager::add(const Particle &particle)
 {
-    particles.emplace_back(particle);
+    particles.add(particle);
+    verlet.invalidate();
+    index_age = 0;
+}
+
+void ParticleManager::set_options(const StepOptions &options)
+{
+    this->options = options;
+    verlet.invalidate();
+    index_age = 0;
+    pool = std::make_unique<ThreadPool>(options.threads);
+    kernel = neighbor_kernel(options.kernel);
+    particles.set_heading_table(HeadingTable(options.heading_table_bits));
+
+    switch (options.index)
+    {
+    case SpatialBackend::grid:
+        if (options.ghost_halo)
+            spatial_index.emplace<HaloGrid>();
+        else
+            spatial_index.emplace<MultiGrid>(options.cell_rebuild_interval > 0);
+        break;
+    case SpatialBackend::hash:
+        spatial_index.emplace<HashGrid>();
+        break;
+    case SpatialBackend::kdtree:
+        spatial_index.emplace<KDTree>();
+        break;
+    case SpatialBackend::quadtree:
+        spatial_index.emplace<QuadTree>();
+        break;
+    }
+}
+
+// Puts particles that are close in space close in memory. permutation[i] is
+// the index particle i had before, so callers can reorder their own arrays.
+void ParticleManager::reorder(const Real simulation_width, const Real simulation_height, std::vector<int> &permutation)
+{
+    std::vector<std::uint32_t> keys(particles.size());
+    for (int i = 0; i < particles.size(); i++)
+        keys[i] = curve_key(options.reorder_curve, particles.position(i), simulation_width, simulation_height);
+
+    permutation.resize(particles.size());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::sort(permutation.begin(), permutation.end(), [&keys](int a, int b) { return keys[a] < keys[b]; });
+
+    particles.permute(permutation);
+
+    verlet.invalidate();
+    index_age = 0;
+}
+
+// Brings the index up to date with the particles, incrementally where the backend and the
+// options allow it.
+template <typename Index>
+void ParticleManager::refresh(Index &index, const Real simulation_width, const Real simulation_height)
+{
+    if constexpr (requires { index.update(radii, *pool); })
+    {
+        if (index_age > 0 && index_age < options.cell_rebuild_interval && index.update(radii, *pool))
+        {
+            index_age++;
+            return;
+        }
+    }
+
+    index.build(particles, simulation_width, simulation_height, radii, *pool);
+    index_age = 1;
 }
 
-void ParticleManager::update(const float simulation_width, const float simulation_height, const std::vector<SpeciesProperties> species)
+// Species is a SpeciesTable or one of its FixedSpeciesTables.
+template <typename Index, typename Species>
+void ParticleManager::step(const Index &index, const Real simulation_width, const Real simulation_height, const Species &species)
 {
-    KDTree tree(simulation_width, simulation_height);
-    for (Particle &particle : particles)
-        tree.insert(&particle);
+    if constexpr (BatchedIndex<Index>)
+    {
+        if (options.batched_queries)
+        {
+            neighborhoods.resize(options.synchronous ? particles.size() : 0);
+            index.for_each_batch(species.max_perception(), [&](const CandidateBatch &batch) {
+                for (int i : batch.queries)
+                {
+                    const SpeciesKernel &properties = species[particles.species[i]];
+                    if (options.synchronous)
+                    {
+                        neighborhoods[i] = particles.neighborhood(i, batch, kernel, simulation_width, simulation_height, properties);
+                        continue;
+                    }
+
+                    particles.update_phi(i, batch, kernel, simulation_width, simulation_height, properties);
+                    particles.move(i, simulation_width, simulation_height, properties.speed);
+                    populations[particles.species[i]][static_cast<int>(particles.population[i])]++;
+                }
+            });
 
-    for (Particle &particle : particles)
+            if (options.synchronous)
+                advance(simulation_width, simulation_height, species);
+            return;
+        }
+    }
+
+    // Every neighbourhood is read from the previous state, the particles only turn and move afterwards.
+    // The queries only read, so with more than one thread they run a tile at a time on the pool.
+    if (options.synchronous)
     {
-        particle.update_phi(tree.search(&particle, species[particle.species].perception), species[particle.species].alpha, species[particle.species].beta, simulation_width, simulation_height);
-        particle.move(simulation_width, simulation_height, species[particle.species].speed);
+        neighborhoods.resize(particles.size());
+        if (pool->size() > 1)
+        {
+            tile(simulation_width, simulation_height);
+            pool->run(static_cast<int>(tiles.start.size()) - 1, [&](int t) {
+                for (int k = tiles.start[t]; k < tiles.start[t + 1]; k++)
+                {
+                    int i = tiles.order[k];
+                    neighborhoods[i] = particles.neighborhood(i, index, kernel, simulation_width, simulation_height, species[particles.species[i]]);
+                }
+            });
+        }
+        else
+        {
+            for (int i = 0; i < particles.size(); i++)
+                neighborhoods[i] = particles.neighborhood(i, index, kernel, simulation_width, simulation_height, species[particles.species[i]]);
+        }
+
+        advance(simulation_width, simulation_height, species);
+        return;
+    }
+
+    for (int i = 0; i < particles.size(); i++)
+    {
+        const SpeciesKernel &properties = species[particles.species[i]];
+        particles.update_phi(i, index, kernel, simulation_width, simulation_height, properties);
+        particles.move(i, simulation_width, simulation_height, properties.speed);
+        populations[particles.species[i]][static_cast<int>(particles.population[i])]++;
+    }
+}
+
+void ParticleManager::update(const Real simulation_width, const Real simulation_height, const std::vector<SpeciesProperties> &species)
+{
+    species_table = SpeciesTable(species);
+    populations.assign(species.size(), PopulationCounts{});
+
+    if (options.quantized_positions && !particles.quantized())
+        particles.quantize(simulation_width, simulation_height);
+
+    // Verlet lists are gathered a skin beyond each species' perception.
+    radii.resize(species.size());
+    for (int s = 0; s < species_table.size(); s++)
+        radii[s] = species_table[s].perception + std::max(options.verlet_skin, Real(0));
+
+    // The backend and the species count are resolved once per step, everything below runs on
+    // their concrete types.
+    std::visit([&](auto &index) {
+        with_fixed_species(species_table, [&](const auto &species) {
+            if (options.pair_traversal)
+            {
+                update_pairs(index, simulation_width, simulation_height, species);
+                return;
+            }
+
+            if (options.verlet_skin > 0)
+            {
+                if (verlet.needs_rebuild(particles, species_table, options.verlet_skin))
+                {
+                    index.build(particles, simulation_width, simulation_height, radii, *pool);
+                    verlet.build(particles, index, species_table, simulation_width, simulation_height, options.verlet_skin);
+                }
+
+                step(verlet, simulation_width, simulation_height, species);
+                return;
+            }
+
+            refresh(index, simulation_width, simulation_height);
+            step(index, simulation_width, simulation_height, species);
+        });
+    }, spatial_index);
+}
+
+template <typename Index, typename Species>
+void ParticleManager::update_pairs(Index &index, const Real simulation_width, const Real simulation_height, const Species &species)
+{
+    // A single level sized for the largest perception serves every pair.
+    Real max_perception = species.max_perception();
+    radii.assign(species.size(), max_perception);
+    refresh(index, simulation_width, simulation_height);
+
+    neighborhoods.assign(particles.size(), Neighborhood());
+
+    // Each side counts the pair only if it lies within its own perception.
+    auto visit_pair = [&](int i, int j, const Vector2D &offset) {
+        Real distance2 = offset.length2();
+
+        if (distance2 < species[particles.species[i]].perception2)
+            neighborhoods[i].add(offset, particles.heading_cos[i], particles.heading_sin[i]);
 
+        if (distance2 < species[particles.species[j]].perception2)
+            neighborhoods[j].add(-offset, particles.heading_cos[j], particles.heading_sin[j]);
+    };
+
+    if constexpr (requires { index.for_each_pair(max_perception, visit_pair); })
+    {
+        index.for_each_pair(max_perception, visit_pair);
+    }
+    else
+    {
+        // Without a pair traversal every pair turns up from both ends, only the lower one keeps it.
+        for (int i = 0; i < particles.size(); i++)
+        {
+            index.for_each_neighbor(i, max_perception, [&](int other, const Vector2D &offset) {
+                if (i < other)
+                    visit_pair(i, other, offset);
+            });
+        }
     }
+
+    advance(simulation_width, simulation_height, species);
+}
+
+// Turns and moves every particle by the neighbourhood gathered for it in neighborhoods. Each
+// particle only touches its own state, so chunks run in parallel and count into their own
+// histograms.
+template <typename Species>
+void ParticleManager::advance(const Real simulation_width, const Real simulation_height, const Species &species)
+{
+    int n_species = static_cast<int>(populations.size());
+    chunk_populations.assign(pool->size() * n_species, PopulationCounts{});
+    pool->for_each_chunk(particles.size(), [&](int chunk, int begin, int end) {
+        PopulationCounts *counts = chunk_populations.data() + chunk * n_species;
+        for (int i = begin; i < end; i++)
+        {
+            const SpeciesKernel &properties = species[particles.species[i]];
+            particles.turn(i, neighborhoods[i], properties);
+            particles.move(i, simulation_width, simulation_height, properties.speed);
+            counts[particles.species[i]][static_cast<int>(particles.population[i])]++;
+        }
+    });
+
+    for (size_t k = 0; k < chunk_populations.size(); k++)
+        for (int p = 0; p < n_populations; p++)
+            populations[k % n_species][p] += chunk_populations[k][p];
+}
+
+// Buckets the particles into a square grid of tiles, several per thread, numbered row by row so
+// that consecutive tiles, which a thread works through in order, are neighbours in space. Crowded
+// tiles take longer than sparse ones; the pool's stealing evens that out.
+void ParticleManager::tile(const Real simulation_width, const Real simulation_height)
+{
+    int per_axis = static_cast<int>(std::ceil(std::sqrt(tiles_per_thread * pool->size())));
+    tile_of.resize(particles.size());
+    pool->for_each_chunk(particles.size(), [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            int column = std::min(static_cast<int>(particles.x[i] / simulation_width * per_axis), per_axis - 1);
+            int row = std::min(static_cast<int>(particles.y[i] / simulation_height * per_axis), per_axis - 1);
+            tile_of[i] = row * per_axis + column;
+        }
+    });
+    tiles.sort(tile_of, per_axis * per_axis, *pool);
+}
+
+// How many particles of each species ended the last update in each population.
+const std::vector<PopulationCounts> &ParticleManager::population_counts() const
+{
+    return populations;
 }
 
 int ParticleManager::size() const
@@ -0,0 +1,148 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <cmath>
+#include <type_traits>
+#include "ParticleStore.h"
+
+ParticleStore::ParticleStore() = default;
+
+Particle ParticleStore::operator[](int i) const
+{
+    Particle particle(x[i], y[i], turns_from_heading(heading[i]), species[i]);
+    particle.n_neighbors = n_neighbors[i];
+    particle.n_close_neighbors = n_close_neighbors[i];
+    return particle;
+}
+
+int ParticleStore::size() const
+{
+    return static_cast<int>(x.size());
+}
+
+void ParticleStore::add(const Particle &particle)
+{
+    x.push_back(particle.position.x);
+    y.push_back(particle.position.y);
+    heading.push_back(heading_from_turns(particle.phi));
+    heading_cos.push_back(0);
+    heading_sin.push_back(0);
+    species.push_back(particle.species);
+    n_neighbors.push_back(particle.n_neighbors);
+    n_close_neighbors.push_back(particle.n_close_neighbors);
+    population.push_back(classify_population(particle.n_neighbors, particle.n_close_neighbors));
+    update_direction(size() - 1);
+
+    if (quantized())
+    {
+        packed.push_back(0);
+        snap(size() - 1);
+    }
+}
+
+// Afterwards particle i is the one that was at permutation[i].
+void ParticleStore::permute(const std::vector<int> &permutation)
+{
+    auto apply = [&permutation](auto &values) {
+        std::remove_reference_t<decltype(values)> permuted(values.size());
+        for (size_t i = 0; i < permutation.size(); i++)
+            permuted[i] = values[permutation[i]];
+        values.swap(permuted);
+    };
+
+    apply(x);
+    apply(y);
+    apply(heading);
+    apply(heading_cos);
+    apply(heading_sin);
+    apply(species);
+    apply(n_neighbors);
+    apply(n_close_neighbors);
+    apply(population);
+    if (quantized())
+        apply(packed);
+}
+
+// Recomputes every cached direction, which may change with the table.
+void ParticleStore::set_heading_table(const HeadingTable &table)
+{
+    this->table = table;
+    for (int i = 0; i < size(); i++)
+        update_direction(i);
+}
+
+// Switches to quantized positions, snapping every particle to the nearest representable point.
+// Power-of-two sizes keep x and y exact. Moves are rounded to whole steps, so a step much
+// coarser than a particle's speed stalls it.
+void ParticleStore::quantize(Real width, Real height)
+{
+    unit_x = width / 65536;
+    unit_y = height / 65536;
+
+    packed.resize(size());
+    for (int i = 0; i < size(); i++)
+        snap(i);
+}
+
+bool ParticleStore::quantized() const
+{
+    return unit_x > 0;
+}
+
+void ParticleStore::snap(int i)
+{
+    std::uint32_t qx = static_cast<std::uint32_t>(std::lround(x[i] / unit_x)) & 0xFFFF;
+    std::uint32_t qy = static_cast<std::uint32_t>(std::lround(y[i] / unit_y)) & 0xFFFF;
+    packed[i] = qx | qy << 16;
+    x[i] = qx * unit_x;
+    y[i] = qy * unit_y;
+}
+
+void ParticleStore::update_direction(int i)
+{
+    table.direction(heading[i], heading_cos[i], heading_sin[i]);
+}
+
+Real ParticleStore::angle(int i) const
+{
+    return static_cast<Real>(atan2(heading_cos[i], -heading_sin[i]) * 180 / M_PI);
+}
+
+void ParticleStore::turn(int i, const Neighborhood &neighborhood, const SpeciesKernel &species)
+{
+    int left = neighborhood.left, right = neighborhood.right;
+    n_close_neighbors[i] = neighborhood.close;
+    n_neighbors[i] = right + left;
+    population[i] = classify_population(n_neighbors[i], n_close_neighbors[i]);
+    std::uint32_t steer = species.beta * static_cast<std::uint32_t>(n_neighbors[i]);
+    heading[i] += species.alpha + ((left > right) ? steer : -steer); // Favour going right.
+    update_direction(i);
+}
+
+void ParticleStore::move(int i, const Real width, const Real height, const Real speed)
+{
+    // The 16-bit coordinates wrap on their own.
+    if (quantized())
+    {
+        std::uint32_t qx = (packed[i] + static_cast<std::uint32_t>(std::lround(heading_cos[i] * speed / unit_x))) & 0xFFFF;
+        std::uint32_t qy = ((packed[i] >> 16) + static_cast<std::uint32_t>(std::lround(heading_sin[i] * speed / unit_y))) & 0xFFFF;
+        packed[i] = qx | qy << 16;
+        x[i] = qx * unit_x;
+        y[i] = qy * unit_y;
+        return;
+    }
+
+    x[i] += heading_cos[i] * speed;
+    y[i] += heading_sin[i] * speed;
+
+    // If particle leaves the screen, update position so the particle wraps around
+    if (x[i] < 0)
+        x[i] += width;
+    if (y[i] < 0)
+        y[i] += height;
+    if (x[i] >= width)
+        x[i] -= width;
+    if (y[i] >= height)
+        y[i] -= height;
+}
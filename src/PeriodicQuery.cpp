@@ -0,0 +1,32 @@
+//
+// Created on 2026-10-17.
+//
+
+#include "PeriodicQuery.h"
+
+PeriodicQuery::PeriodicQuery(const Vector2D &position, Real radius, Real width, Real height)
+{
+    this->position = position;
+    this->radius = radius;
+
+    // Only shift the query across a border that its disk actually crosses.
+    Real shifts_x[3] = {0, 0, 0}, shifts_y[3] = {0, 0, 0};
+    int n_x = 1, n_y = 1;
+    if (position.x - radius < 0)
+        shifts_x[n_x++] = width;
+    if (position.x + radius >= width)
+        shifts_x[n_x++] = -width;
+    if (position.y - radius < 0)
+        shifts_y[n_y++] = height;
+    if (position.y + radius >= height)
+        shifts_y[n_y++] = -height;
+
+    for (int i = 0; i < n_x; i++)
+        for (int j = 0; j < n_y; j++)
+            images[n_images++] = Vector2D{position.x + shifts_x[i], position.y + shifts_y[j]};
+}
+
+unsigned PeriodicQuery::all_images() const
+{
+    return (1u << n_images) - 1;
+}
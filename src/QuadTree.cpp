@@ -0,0 +1,61 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <numeric>
+#include "QuadTree.h"
+
+QuadTree::QuadTree() = default;
+
+void QuadTree::build(const ParticleStore &particles, Real width, Real height)
+{
+    this->width = width;
+    this->height = height;
+    this->particles = &particles;
+
+    order.resize(particles.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    nodes.clear();
+    nodes.push_back(Node{0, 0, width, height, 0, static_cast<int>(order.size()), -1, 0});
+
+    // Appending children while walking the array splits the tree breadth first.
+    for (size_t node = 0; node < nodes.size(); node++)
+    {
+        if (nodes[node].end - nodes[node].begin > leaf_capacity && nodes[node].depth < max_depth)
+            split(node);
+    }
+}
+
+// The tree adapts to any query radius, so it does not need the species radii. Its breadth
+// first layout is built on the calling thread.
+void QuadTree::build(const ParticleStore &particles, Real width, Real height, const std::vector<Real> &, ThreadPool &)
+{
+    build(particles, width, height);
+}
+
+void QuadTree::split(int node)
+{
+    Node current = nodes[node];
+    Real mid_x = (current.min_x + current.max_x) / 2;
+    Real mid_y = (current.min_y + current.max_y) / 2;
+
+    auto below = [this, mid_y](int i) { return particles->y[i] < mid_y; };
+    auto left_of = [this, mid_x](int i) { return particles->x[i] < mid_x; };
+
+    auto first = order.begin() + current.begin, last = order.begin() + current.end;
+    auto middle = std::partition(first, last, below);
+    auto bottom = std::partition(first, middle, left_of);
+    auto top = std::partition(middle, last, left_of);
+
+    int begin = current.begin;
+    int split_bottom = bottom - order.begin(), split_y = middle - order.begin(), split_top = top - order.begin();
+    int depth = current.depth + 1;
+
+    nodes[node].children = static_cast<int>(nodes.size());
+    nodes.push_back(Node{current.min_x, current.min_y, mid_x, mid_y, begin, split_bottom, -1, depth});
+    nodes.push_back(Node{mid_x, current.min_y, current.max_x, mid_y, split_bottom, split_y, -1, depth});
+    nodes.push_back(Node{current.min_x, mid_y, mid_x, current.max_y, split_y, split_top, -1, depth});
+    nodes.push_back(Node{mid_x, mid_y, current.max_x, current.max_y, split_top, current.end, -1, depth});
+}
@@ -14,7 +14,7 @@
 #include "Simulation.h"
 
 Simulation::Simulation(std::vector<SpeciesProperties> species, int window_width, int window_height, int simulation_width, int simulation_height,
-                       float draw_size, int log_interval, std::string log_file, int exit_after, bool headless, bool fullscreen, bool light_scheme, bool log_screenshot)
+                       float draw_size, int log_interval, std::string log_file, int exit_after, bool headless, bool fullscreen, bool light_scheme, bool log_screenshot, StepOptions step_options)
 {
     this->_m_is_headless = headless;
     sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
@@ -48,11 +48,10 @@ Simulation::Simulation(std::vector<SpeciesProperties> species, int window_width,
     this->_m_log_file = log_file;
     this->_m_exit_after = exit_after;
     this->_m_log_screenshot = log_screenshot;
+    this->_m_step_options = step_options;
+    this->_m_particle_manager.set_options(step_options);
 
-    for (size_t i = 0; i < _m_species.size(); i++)
-    {
-        _m_population_count.push_back({0, 0, 0, 0, 0});
-    }
+    _m_population_count.assign(_m_species.size(), PopulationCounts{});
 
     _init_log();
 
@@ -62,11 +61,7 @@ Simulation::Simulation(std::vector<SpeciesProperties> species, int window_width,
 
 void Simulation::_reset_population_count()
 {
-    for (auto &&species : _m_population_count)
-    {
-        species.clear();
-        species.insert(species.begin(), 5, 0);
-    }
+    _m_population_count.assign(_m_species.size(), PopulationCounts{});
 }
 
 Simulation::~Simulation() = default;
@@ -115,10 +110,6 @@ void Simulation::run(float particle_density)
         while (_m_generation <= _m_exit_after)
         {
             _update();
-            for (size_t i = 0; i < _m_particle_manager.size(); i++)
-            {
-                _neighborhood_color(_m_particle_manager[i]);
-            }
             _try_log();
         }
     }
@@ -145,8 +136,18 @@ void Simulation::_update()
 {
     _m_generation++;
     _m_since_last_log++;
+    if (_m_step_options.reorder_interval > 0 && _m_generation % _m_step_options.reorder_interval == 0)
+    {
+        _reorder();
+    }
     _m_particle_manager.update(_m_simulation_width, _m_simulation_height, _m_species);
 
+    // The step sorts the particles into populations as it goes.
+    const std::vector<PopulationCounts> &counts = _m_particle_manager.population_counts();
+    for (size_t s = 0; s < counts.size(); s++)
+        for (int p = 0; p < n_populations; p++)
+            _m_population_count[s][p] += counts[s][p];
+
     // Skip every other frame (useful for alpha=180).
     if (!_m_is_headless && _m_is_renderframe)
     {
@@ -155,48 +156,36 @@ void Simulation::_update()
     _m_is_renderframe = !_m_is_renderframe;
 }
 
-sf::Color Simulation::_neighborhood_color(const Particle &particle)
+void Simulation::_reorder()
 {
-    int n_neighbors = particle.n_neighbors;
-    int n_close_neighbors = particle.n_close_neighbors;
-    int species = particle.species;
-
-    if (n_close_neighbors > 15) //Nt,r=1.3 > 15
-    {
-        _m_population_count[species][3]++;
-        return sf::Color::Magenta;
-    }
-    else if (15 < n_neighbors && n_neighbors <= 35) //15 < Nt,r=5 ≤ 35
-    {
-        _m_population_count[species][1]++;
-        return sf::Color::Blue;
-    }
-    else if (n_neighbors > 35) //Nt,r=5 > 35
-    {
-        _m_population_count[species][0]++;
-        return sf::Color::Yellow;
-    }
-    else if (13 <= n_neighbors && n_neighbors <= 15) //13 ≤ Nt,r=5 ≤ 15
-    {
-        _m_population_count[species][2]++;
-        return {200, 100, 0, 255}; // Brown
-    }
+    std::vector<int> permutation;
+    _m_particle_manager.reorder(_m_simulation_width, _m_simulation_height, permutation);
+
+    // Shapes are indexed like the particles, so they follow the same permutation.
+    std::vector<sf::CircleShape> shapes;
+    shapes.reserve(_m_shapes.size());
+    for (int i : permutation)
+        shapes.emplace_back(_m_shapes[i]);
+    _m_shapes.swap(shapes);
+}
 
-    _m_population_count[species][4]++;
-    return sf::Color::Green;
+sf::Color Simulation::_neighborhood_color(Population population)
+{
+    static const sf::Color colors[n_populations] = {sf::Color::Yellow, sf::Color::Blue, {200, 100, 0, 255}, sf::Color::Magenta, sf::Color::Green};
+    return colors[static_cast<int>(population)];
 }
 
 void Simulation::_render()
 {
     _m_window->clear(_m_use_light_scheme ? sf::Color::White : sf::Color::Black);
 
+    const ParticleStore &particles = _m_particle_manager.store();
     for (size_t i = 0; i < _m_shapes.size(); ++i)
     {
-        Particle particle = _m_particle_manager[i];
-        _m_shapes[i].setPosition(particle.position.x, particle.position.y);
-        _m_shapes[i].setRotation(particle.angle());
-        sf::Color density_color = _neighborhood_color(particle);
-        sf::Color species_color = _m_species[particle.species].color;
+        _m_shapes[i].setPosition(particles.x[i], particles.y[i]);
+        _m_shapes[i].setRotation(particles.angle(i));
+        sf::Color density_color = _neighborhood_color(particles.population[i]);
+        sf::Color species_color = _m_species[particles.species[i]].color;
 
         sf::Color c = _m_use_density_colors ? density_color : species_color;
         _m_shapes[i].setFillColor(c);
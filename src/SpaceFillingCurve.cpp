@@ -0,0 +1,56 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <utility>
+#include "SpaceFillingCurve.h"
+
+static std::uint32_t quantize(Real value, Real extent)
+{
+    return static_cast<std::uint32_t>(std::clamp<Real>(value / extent * 65536, 0, 65535));
+}
+
+static std::uint32_t spread_bits(std::uint32_t v)
+{
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+static std::uint32_t morton_key(std::uint32_t x, std::uint32_t y)
+{
+    return spread_bits(x) | (spread_bits(y) << 1);
+}
+
+static std::uint32_t hilbert_key(std::uint32_t x, std::uint32_t y)
+{
+    std::uint32_t key = 0;
+    for (std::uint32_t s = 1u << 15; s > 0; s >>= 1)
+    {
+        std::uint32_t rx = (x & s) > 0;
+        std::uint32_t ry = (y & s) > 0;
+        key += s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant so the curve stays continuous.
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return key;
+}
+
+std::uint32_t curve_key(SpaceFillingCurve curve, const Vector2D &position, Real width, Real height)
+{
+    std::uint32_t x = quantize(position.x, width);
+    std::uint32_t y = quantize(position.y, height);
+    return curve == SpaceFillingCurve::hilbert ? hilbert_key(x, y) : morton_key(x, y);
+}
@@ -0,0 +1,36 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include "SpeciesTable.h"
+#include "SpeciesProperties.h"
+#include "HeadingTable.h"
+
+SpeciesTable::SpeciesTable() = default;
+
+SpeciesTable::SpeciesTable(const std::vector<SpeciesProperties> &species)
+{
+    kernels.resize(species.size());
+    for (size_t s = 0; s < species.size(); s++)
+    {
+        const SpeciesProperties &properties = species[s];
+        SpeciesKernel &kernel = kernels[s];
+        kernel.speed = properties.speed;
+        kernel.perception = properties.perception;
+        kernel.perception2 = properties.perception * properties.perception;
+        kernel.alpha = heading_from_turns(properties.alpha / 360.0);
+        kernel.beta = heading_from_turns(properties.beta / 360.0);
+        largest_perception = std::max(largest_perception, properties.perception);
+    }
+}
+
+int SpeciesTable::size() const
+{
+    return static_cast<int>(kernels.size());
+}
+
+Real SpeciesTable::max_perception() const
+{
+    return largest_perception;
+}
@@ -0,0 +1,144 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include "ThreadPool.h"
+
+static std::uint64_t pack(int begin, int end)
+{
+    return static_cast<std::uint32_t>(begin) | static_cast<std::uint64_t>(end) << 32;
+}
+
+static int begin_of(std::uint64_t bounds)
+{
+    return static_cast<int>(bounds & 0xFFFFFFFF);
+}
+
+static int end_of(std::uint64_t bounds)
+{
+    return static_cast<int>(bounds >> 32);
+}
+
+ThreadPool::ThreadPool(int n_threads)
+{
+    if (n_threads <= 0)
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // The thread calling run() takes tasks as well, as thread 0.
+    shares = std::make_unique<Share[]>(n_threads);
+    for (int i = 1; i < n_threads; i++)
+        workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+int ThreadPool::size() const
+{
+    return static_cast<int>(workers.size()) + 1;
+}
+
+void ThreadPool::run(int n_tasks, const std::function<void(int)> &task)
+{
+    if (workers.empty() || n_tasks <= 1)
+    {
+        for (int i = 0; i < n_tasks; i++)
+            task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        int n_threads = size();
+        for (int t = 0; t < n_threads; t++)
+            shares[t].bounds = pack(static_cast<int>(static_cast<long long>(n_tasks) * t / n_threads), static_cast<int>(static_cast<long long>(n_tasks) * (t + 1) / n_threads));
+        busy = static_cast<int>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    this->task = nullptr;
+}
+
+void ThreadPool::work(int thread)
+{
+    unsigned seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        drain(thread);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+            done.notify_one();
+    }
+}
+
+void ThreadPool::drain(int thread)
+{
+    int i;
+    while (take(thread, i) || steal(thread, i))
+        (*task)(i);
+}
+
+// Takes the first task of the thread's own share.
+bool ThreadPool::take(int thread, int &i)
+{
+    std::uint64_t bounds = shares[thread].bounds;
+    while (begin_of(bounds) < end_of(bounds))
+    {
+        if (shares[thread].bounds.compare_exchange_weak(bounds, pack(begin_of(bounds) + 1, end_of(bounds))))
+        {
+            i = begin_of(bounds);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cuts the back half off the first other share that has tasks left, runs its first task as i
+// and keeps the rest as the thread's own share. Shares only ever shrink or, once empty, take
+// a stolen piece, so a compare-and-swap can not mistake a refilled share for the one it read.
+bool ThreadPool::steal(int thread, int &i)
+{
+    int n_threads = size();
+    for (int k = 1; k < n_threads; k++)
+    {
+        Share &victim = shares[(thread + k) % n_threads];
+        std::uint64_t bounds = victim.bounds;
+        while (begin_of(bounds) < end_of(bounds))
+        {
+            int begin = begin_of(bounds), end = end_of(bounds);
+            int middle = begin + (end - begin) / 2;
+            if (victim.bounds.compare_exchange_weak(bounds, pack(begin, middle)))
+            {
+                i = middle;
+                shares[thread].bounds = pack(middle + 1, end);
+                return true;
+            }
+        }
+    }
+    return false;
+}
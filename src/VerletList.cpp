@@ -0,0 +1,33 @@
+//
+// Created on 2026-10-17.
+//
+
+#include <algorithm>
+#include <cmath>
+#include "VerletList.h"
+
+VerletList::VerletList() = default;
+
+void VerletList::invalidate()
+{
+    valid = false;
+}
+
+// Callers invalidate the lists after adding or reordering particles.
+bool VerletList::needs_rebuild(const ParticleStore &particles, const SpeciesTable &species, Real skin) const
+{
+    if (!valid || skin != this->skin || particles.size() != static_cast<int>(origin.size()))
+        return true;
+
+    Real max_speed = 0;
+    for (int s = 0; s < species.size(); s++)
+        max_speed = std::max(max_speed, species[s].speed);
+
+    Real max_displacement2 = 0;
+    for (int i = 0; i < particles.size(); i++)
+        max_displacement2 = std::max(max_displacement2, origin[i].toroidal_distance2(particles.position(i), width, height));
+
+    // Two particles closing in on each other must not cover the skin, and a neighbour may already
+    // have taken this step's move by the time it is read.
+    return 2 * std::sqrt(max_displacement2) + max_speed > skin;
+}
@@ -3,6 +3,7 @@
 //
 
 #include <string>
+#include <algorithm>
 #include <string_view>
 #include <iostream>
 #include <fstream>
@@ -24,6 +25,19 @@ int main(int argc, char **argv)
         ("config_file", "Species configuration file.",cxxopts::value<std::string>()->default_value(std::string(Simulation::default_config_file)))
         ("log_file", "Species logging file.",cxxopts::value<std::string>()->default_value(std::string(Simulation::default_log_file)))
         ("exit_after", "Exit program after [n] steps.",cxxopts::value<int>()->default_value(std::to_string(Simulation::default_exit_after)))
+        ("verlet_skin", "Skin radius of the Verlet neighbour lists, 0 disables them.",cxxopts::value<Real>()->default_value("0"))
+        ("reorder_interval", "Sort particles along a space-filling curve every [n] steps, 0 disables it.",cxxopts::value<int>()->default_value("0"))
+        ("reorder_curve", "Space-filling curve used for sorting (hilbert, morton).",cxxopts::value<std::string>()->default_value("hilbert"))
+        ("pair_traversal", "Visit each neighbour pair once and update all particles synchronously.")
+        ("synchronous", "Update all particles from the previous step's state, independent of visiting order.")
+        ("spatial_index", "Structure for neighbour queries (grid, hash, kdtree, quadtree).",cxxopts::value<std::string>()->default_value("grid"))
+        ("batched_queries", "Query tree indices once per leaf bucket instead of once per particle.")
+        ("ghost_halo", "Pad the grid with ghost copies of border particles instead of wrapping queries.")
+        ("cell_rebuild_interval", "Keep grid cells between steps and rebuild them every this many steps, 0 rebuilds every step.",cxxopts::value<int>()->default_value("0"))
+        ("kernel", "Instruction set for the neighbour kernel (auto, scalar, avx2, avx512).",cxxopts::value<std::string>()->default_value("auto"))
+        ("heading_table_bits", "Look up heading cosines in a table of 2^bits entries, 0 computes them exactly.",cxxopts::value<int>()->default_value("0"))
+        ("quantized_positions", "Keep positions as 16-bit torus coordinates.")
+        ("threads", "Number of threads, 0 uses all hardware threads. The step itself runs in parallel with --synchronous.",cxxopts::value<int>()->default_value("0"))
         ("headless", "Run headless.")
         ("fullscreen", "Runs the simulation in a fullscreen window.")
         ("light_scheme", "Uses a light color scheme.")
@@ -50,7 +64,7 @@ int main(int argc, char **argv)
 
     while (!config_file.eof())
     {
-        float speed, perception, alpha, beta;
+        Real speed, perception, alpha, beta;
         int R, G, B, A;
 
         config_file >> speed;
@@ -73,10 +87,98 @@ int main(int argc, char **argv)
 
     config_file.close();
 
+    StepOptions step_options;
+    step_options.verlet_skin = result["verlet_skin"].as<Real>();
+    step_options.reorder_interval = result["reorder_interval"].as<int>();
+    step_options.pair_traversal = result["pair_traversal"].as<bool>();
+    step_options.synchronous = result["synchronous"].as<bool>();
+    step_options.batched_queries = result["batched_queries"].as<bool>();
+    step_options.ghost_halo = result["ghost_halo"].as<bool>();
+    step_options.cell_rebuild_interval = result["cell_rebuild_interval"].as<int>();
+    step_options.heading_table_bits = result["heading_table_bits"].as<int>();
+    step_options.quantized_positions = result["quantized_positions"].as<bool>();
+    step_options.threads = result["threads"].as<int>();
+
+    if (result["spatial_index"].as<std::string>() == "hash")
+    {
+        step_options.index = SpatialBackend::hash;
+    }
+    else if (result["spatial_index"].as<std::string>() == "kdtree")
+    {
+        step_options.index = SpatialBackend::kdtree;
+    }
+    else if (result["spatial_index"].as<std::string>() == "quadtree")
+    {
+        step_options.index = SpatialBackend::quadtree;
+    }
+    else if (result["spatial_index"].as<std::string>() != "grid")
+    {
+        std::cout << "Unknown spatial index." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // The ghost layer holds everything within perception plus skin of a border, and may not reach past the middle.
+    if (step_options.ghost_halo && step_options.index == SpatialBackend::grid)
+    {
+        Real halo = 0;
+        for (const SpeciesProperties &properties : species)
+            halo = std::max(halo, properties.perception + std::max(step_options.verlet_skin, Real(0)));
+
+        if (2 * halo > result["simulation_width"].as<int>() || 2 * halo > result["simulation_height"].as<int>())
+        {
+            std::cout << "Ghost halo is wider than half the simulation area." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Moves are rounded to whole 16-bit coordinate steps, so a step has to be a small fraction of the
+    // slowest species' speed, or its particles drift at the wrong speed or do not move at all.
+    if (step_options.quantized_positions)
+    {
+        Real step = std::max(result["simulation_width"].as<int>(), result["simulation_height"].as<int>()) / Real(65536);
+        for (const SpeciesProperties &properties : species)
+        {
+            if (properties.speed > 0 && step > properties.speed / 32)
+            {
+                std::cout << "Simulation area is too large for quantized positions at this speed." << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    if (result["kernel"].as<std::string>() == "scalar")
+    {
+        step_options.kernel = KernelIsa::scalar;
+    }
+    else if (result["kernel"].as<std::string>() == "avx2")
+    {
+        step_options.kernel = KernelIsa::avx2;
+    }
+    else if (result["kernel"].as<std::string>() == "avx512")
+    {
+        step_options.kernel = KernelIsa::avx512;
+    }
+    else if (result["kernel"].as<std::string>() != "auto")
+    {
+        std::cout << "Unknown kernel." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (result["reorder_curve"].as<std::string>() == "morton")
+    {
+        step_options.reorder_curve = SpaceFillingCurve::morton;
+    }
+    else if (result["reorder_curve"].as<std::string>() != "hilbert")
+    {
+        std::cout << "Unknown space-filling curve." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
     Simulation simulation(species, result["window_width"].as<int>(), result["window_height"].as<int>(),
                           result["simulation_width"].as<int>(), result["simulation_height"].as<int>(),
                           result["draw_size"].as<float>(), result["log_interval"].as<int>(), result["log_file"].as<std::string>(), result["exit_after"].as<int>(),
-                          result["headless"].as<bool>(), result["fullscreen"].as<bool>(), result["light_scheme"].as<bool>(), result["log_screenshot"].as<bool>());
+                          result["headless"].as<bool>(), result["fullscreen"].as<bool>(), result["light_scheme"].as<bool>(), result["log_screenshot"].as<bool>(),
+                          step_options);
 
     simulation.run(result["particle_density"].as<float>());
 